@@ -22,10 +22,15 @@
 
 # create an empty allsyms source file for `nuttx`
 if(CONFIG_ALLSYMS)
+  if(CONFIG_ALLSYMS_INDEX)
+    set(ALLSYMS_FLAGS --index y)
+  endif()
+
   set(ALLSYMS_SOURCE ${CMAKE_BINARY_DIR}/allsyms_empty.c)
   add_custom_command(
     OUTPUT ${ALLSYMS_SOURCE}
     COMMAND ${NUTTX_DIR}/tools/mkallsyms.py nuttx.empty ${ALLSYMS_SOURCE}
+            ${ALLSYMS_FLAGS}
     WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
     COMMENT "Generating allsyms_empty.c")
   add_custom_target(generate_empty_allsyms DEPENDS ${ALLSYMS_SOURCE})
@@ -83,7 +88,7 @@ macro(define_multiple_link_target inter_target dep_target linktimes)
     add_custom_command(
       OUTPUT ${LINK_ALLSYMS_SOURCE} POST_BUILD
       COMMAND ${NUTTX_DIR}/tools/mkallsyms.py ${CMAKE_BINARY_DIR}/${dep_target}
-              ${LINK_ALLSYMS_SOURCE}
+              ${LINK_ALLSYMS_SOURCE} ${ALLSYMS_FLAGS}
       DEPENDS ${dep_target}
       WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
       COMMAND_EXPAND_LISTS)
@@ -437,9 +437,17 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       case BIOC_DISCARD:
         {
-          /* Invalidate the sector so next read is from the device- */
+          /* Invalidate the sector buffer so next read is from the device.
+           * Modified sectors are written back first, as the buffer may hold
+           * sectors outside of the discarded range.
+           */
+
+          ret = bchlib_flushsector(bch, true);
+          if (ret < 0)
+            {
+              break;
+            }
 
-          bch->sector = (size_t)-1;
           goto ioctl_default;
         }
 
@@ -59,37 +59,163 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
 
 /****************************************************************************
  * Name: bch_cypher
+ *
+ * Description:
+ *   Encrypt or decrypt the sectors from 'start' up to (but not including)
+ *   'end' in the sector buffer.
+ *
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, size_t start, size_t end,
+                      int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)BCH_SECTBUF(bch, start);
+  size_t sector;
   int i;
 
-  for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
+  for (sector = start; sector < end; sector++)
+    {
+      for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t))
+        {
+          uint32_t T[4];
+          uint32_t X[4] =
+          {
+            sector, 0, 0, i
+          };
+
+          aes_cypher(X, X, 16, NULL, bch->key,
+                     CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                     AES_MODE_ECB, CYPHER_ENCRYPT);
+
+          /* Xor-Encrypt-Xor */
+
+          bch_xor(T, X, buffer);
+          aes_cypher(T, T, 16, NULL, bch->key,
+                     CONFIG_BCH_ENCRYPTION_KEY_SIZE,
+                     AES_MODE_ECB, encrypt);
+          bch_xor(buffer, X, T);
+        }
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: bchlib_loadsector
+ *
+ * Description:
+ *   Make 'sector' present in the sector buffer, reading it from the media
+ *   if 'read' is true.
+ *
+ *   The buffer holds up to CONFIG_BCH_CACHE_SECTORS consecutive sectors.
+ *   An access to the sector that follows the buffered ones is taken as
+ *   sequential: the buffer is then extended, or refilled when it is full,
+ *   with as many following sectors as fit.  Any other access replaces the
+ *   buffer content with the single sector.  Modified sectors are written
+ *   back before they leave the buffer.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+static int bchlib_loadsector(FAR struct bchlib_s *bch, size_t sector,
+                             bool read)
+{
+  FAR struct inode *inode;
+  size_t nsectors = 1;
+  ssize_t ret;
+
+  if (bch->buffer == NULL)
     {
-      uint32_t T[4];
-      uint32_t X[4] =
-      {
-        bch->sector, 0, 0, i
-      };
+#if CONFIG_BCH_BUFFER_ALIGNMENT != 0
+      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                                 bch->sectsize * CONFIG_BCH_CACHE_SECTORS);
+#else
+      bch->buffer = kmm_malloc(bch->sectsize * CONFIG_BCH_CACHE_SECTORS);
+#endif
+      if (bch->buffer == NULL)
+        {
+          ferr("Failed to allocate sector buffer\n");
+          return -ENOMEM;
+        }
+    }
 
-      aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, CYPHER_ENCRYPT);
+  /* Is the sector already in the buffer? */
 
-      /* Xor-Encrypt-Xor */
+  if (sector - bch->sector < bch->count)
+    {
+      return OK;
+    }
+
+  if (bch->count > 0 && sector == bch->sector + bch->count)
+    {
+      /* Sequential access */
+
+      if (bch->count >= CONFIG_BCH_CACHE_SECTORS)
+        {
+          ret = bchlib_flushsector(bch, true);
+          if (ret < 0)
+            {
+              ferr("Flush failed: %zd\n", ret);
+              return (int)ret;
+            }
+        }
+
+      nsectors = CONFIG_BCH_CACHE_SECTORS - bch->count;
+    }
+  else
+    {
+      ret = bchlib_flushsector(bch, true);
+      if (ret < 0)
+        {
+          ferr("Flush failed: %zd\n", ret);
+          return (int)ret;
+        }
+    }
+
+  if (bch->count == 0)
+    {
+      bch->sector = sector;
+    }
+
+  if (!read)
+    {
+      /* The caller will overwrite the whole sector */
+
+      nsectors = 1;
+    }
+  else
+    {
+      if (nsectors > bch->nsectors - sector)
+        {
+          nsectors = bch->nsectors - sector;
+        }
+
+      inode = bch->inode;
+      ret = inode->u.i_bops->read(inode, BCH_SECTBUF(bch, sector), sector,
+                                  nsectors);
+      if (ret < 0)
+        {
+          ferr("Read failed: %zd\n", ret);
+          return (int)ret;
+        }
+      else if (ret > 0 && (size_t)ret < nsectors)
+        {
+          nsectors = ret;
+        }
 
-      bch_xor(T, X, buffer);
-      aes_cypher(T, T, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
-                 AES_MODE_ECB, encrypt);
-      bch_xor(buffer, X, T);
+#if defined(CONFIG_BCH_ENCRYPTION)
+      bch_cypher(bch, sector, sector + nsectors, CYPHER_DECRYPT);
+#endif
     }
 
+  bch->count += nsectors;
   return OK;
 }
-#endif
 
 /****************************************************************************
  * Public Functions
@@ -99,7 +225,8 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Write the modified sectors in the sector buffer (if any) back to the
+ *   media, and forget the buffer content if 'discard' is true.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -111,23 +238,25 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
   FAR struct inode *inode;
   ssize_t ret = OK;
 
-  /* Check if the sector has been modified and is out of synch with the
+  /* Check if sectors have been modified and are out of synch with the
    * media.
    */
 
-  if (bch->dirty && bch->buffer != NULL)
+  if (bch->dirtyend > bch->dirtystart && bch->buffer != NULL)
     {
       inode = bch->inode;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, bch->dirtystart, bch->dirtyend, CYPHER_ENCRYPT);
 #endif
 
-      /* Write the sector to the media */
+      /* Write all of the modified sectors to the media at once */
 
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      ret = inode->u.i_bops->write(inode, BCH_SECTBUF(bch, bch->dirtystart),
+                                   bch->dirtystart,
+                                   bch->dirtyend - bch->dirtystart);
       if (ret < 0)
         {
           ferr("Write failed: %zd\n", ret);
@@ -139,17 +268,19 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->dirtystart, bch->dirtyend, CYPHER_DECRYPT);
 #endif
 
-      /* The sector is now in sync with the media */
+      /* The sectors are now in sync with the media */
 
-      bch->dirty = false;
+      bch->dirtystart = 0;
+      bch->dirtyend   = 0;
     }
 
   if (discard)
     {
       bch->sector = (size_t)-1;
+      bch->count  = 0;
     }
 
   return (int)ret;
@@ -159,7 +290,8 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
  * Name: bchlib_readsector
  *
  * Description:
- *   Read the current sector contents into buffer
+ *   Make the contents of 'sector' available in the sector buffer at
+ *   BCH_SECTBUF(bch, sector), reading ahead on sequential access.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -168,46 +300,76 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
-  FAR struct inode *inode;
-  ssize_t ret = OK;
+  return bchlib_loadsector(bch, sector, true);
+}
 
-  if (bch->buffer == NULL)
+/****************************************************************************
+ * Name: bchlib_newsector
+ *
+ * Description:
+ *   Make room for 'sector' in the sector buffer without reading it.  The
+ *   caller must overwrite the whole sector and mark it dirty.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_newsector(FAR struct bchlib_s *bch, size_t sector)
+{
+  return bchlib_loadsector(bch, sector, false);
+}
+
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Mark a sector in the sector buffer as modified.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_dirtysector(FAR struct bchlib_s *bch, size_t sector)
+{
+  if (bch->dirtyend <= bch->dirtystart)
     {
-#if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-      bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
-#else
-      bch->buffer = kmm_malloc(bch->sectsize);
-#endif
-      if (bch->buffer == NULL)
-        {
-          ferr("Failed to allocate sector buffer\n");
-          return -ENOMEM;
-        }
+      bch->dirtystart = sector;
+      bch->dirtyend   = sector + 1;
     }
-
-  if (bch->sector != sector)
+  else if (sector < bch->dirtystart)
     {
-      inode = bch->inode;
-
-      ret = bchlib_flushsector(bch, true);
-      if (ret < 0)
-        {
-          ferr("Flush failed: %zd\n", ret);
-          return (int)ret;
-        }
+      bch->dirtystart = sector;
+    }
+  else if (sector >= bch->dirtyend)
+    {
+      bch->dirtyend = sector + 1;
+    }
+}
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
-      if (ret < 0)
-        {
-          ferr("Read failed: %zd\n", ret);
-          return (int)ret;
-        }
+/****************************************************************************
+ * Name: bchlib_syncsectors
+ *
+ * Description:
+ *   Prepare for a transfer of 'nsectors' sectors from 'sector' that does
+ *   not go through the sector buffer:  If the buffer holds any of these
+ *   sectors, write back its modified sectors and forget its content if
+ *   'discard' is true.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
 
-      bch->sector = sector;
-#if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
-#endif
+int bchlib_syncsectors(FAR struct bchlib_s *bch, size_t sector,
+                       size_t nsectors, bool discard)
+{
+  if (bch->count > 0 && sector < bch->sector + bch->count &&
+      bch->sector < sector + nsectors)
+    {
+      return bchlib_flushsector(bch, discard);
     }
 
-  return (int)ret;
+  return OK;
 }
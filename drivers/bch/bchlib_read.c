@@ -120,7 +120,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nbytes = len;
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
+      memcpy(buffer, BCH_SECTBUF(bch, sector) + sectoffset, nbytes);
 
       /* Adjust pointers and counts */
 
@@ -136,16 +136,51 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
       len       -= nbytes;
     }
 
-  /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
+  /* Then read all of the full sectors following the partial sector.  Fewer
+   * sectors than the sector buffer holds are read through the buffer, so
+   * that small sequential reads benefit from read-ahead.
    */
 
-  if (len >= bch->sectsize)
+  nsectors = len / bch->sectsize;
+  if (sector + nsectors > bch->nsectors)
     {
-      nsectors = len / bch->sectsize;
-      if (sector + nsectors > bch->nsectors)
+      nsectors = bch->nsectors - sector;
+    }
+
+  if (nsectors > 0 && nsectors < CONFIG_BCH_CACHE_SECTORS)
+    {
+      for (; nsectors > 0; nsectors--)
         {
-          nsectors = bch->nsectors - sector;
+          ret = bchlib_readsector(bch, sector);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          memcpy(buffer, BCH_SECTBUF(bch, sector), bch->sectsize);
+
+          sector++;
+          bytesread += bch->sectsize;
+          buffer    += bch->sectsize;
+          len       -= bch->sectsize;
+        }
+
+      if (sector >= bch->nsectors)
+        {
+          return bytesread;
+        }
+    }
+
+  /* Larger transfers go directly into the user buffer */
+
+  if (nsectors > 0)
+    {
+      /* Modified sectors in the buffer must reach the media first */
+
+      ret = bchlib_syncsectors(bch, sector, nsectors, false);
+      if (ret < 0)
+        {
+          return ret;
         }
 
       ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
@@ -185,7 +220,7 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
 
       /* Copy the head end of the sector to the user buffer */
 
-      memcpy(buffer, bch->buffer, len);
+      memcpy(buffer, BCH_SECTBUF(bch, sector), len);
 
       /* Adjust counts */
 
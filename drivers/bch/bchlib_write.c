@@ -106,8 +106,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           nbytes = len;
         }
 
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      memcpy(BCH_SECTBUF(bch, sector) + sectoffset, buffer, nbytes);
+      bchlib_dirtysector(bch, sector);
 
       /* Adjust pointers and counts */
 
@@ -130,11 +130,22 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
   /* indirectly by using sector buffer.
    */
 
-  while (len > 0)
+  while (len > 0 && sector < bch->nsectors)
     {
-      /* Read the sector into the sector buffer */
+      /* Get the sector into the sector buffer.  A sector that is
+       * completely overwritten need not be read.
+       */
+
+      nbytes = len > bch->sectsize ? bch->sectsize : len;
+      if (nbytes == bch->sectsize)
+        {
+          ret = bchlib_newsector(bch, sector);
+        }
+      else
+        {
+          ret = bchlib_readsector(bch, sector);
+        }
 
-      ret = bchlib_readsector(bch, sector);
       if (ret < 0)
         {
           return ret;
@@ -142,17 +153,21 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       /* Copy the data from the user buffer to the sector buffer */
 
-      nbytes = len > bch->sectsize ? bch->sectsize : len;
-      memcpy(bch->buffer, buffer, nbytes);
-      bch->dirty = true;
+      memcpy(BCH_SECTBUF(bch, sector), buffer, nbytes);
+      bchlib_dirtysector(bch, sector);
 
-      /* Write the sector back to the block device */
+      /* Write the sectors back to the block device once the sector buffer
+       * is full.
+       */
 
-      ret = bchlib_flushsector(bch, false);
-      if (ret < 0)
+      if (bch->count >= CONFIG_BCH_CACHE_SECTORS)
         {
-          ferr("ERROR: Flush failed: %d\n", ret);
-          return ret;
+          ret = bchlib_flushsector(bch, false);
+          if (ret < 0)
+            {
+              ferr("ERROR: Flush failed: %d\n", ret);
+              return ret;
+            }
         }
 
       /* Adjust pointers and counts */
@@ -164,21 +179,50 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
     }
 #else
 
-  /* directly from the user buffer.
+  /* directly from the user buffer.  Fewer sectors than the sector buffer
+   * holds are collected in the buffer instead, so that small sequential
+   * writes reach the block device in larger transfers.
    */
 
-  if (len >= bch->sectsize)
+  nsectors = len / bch->sectsize;
+  if (sector + nsectors > bch->nsectors)
+    {
+      nsectors = bch->nsectors - sector;
+    }
+
+  if (nsectors > 0 && nsectors < CONFIG_BCH_CACHE_SECTORS)
     {
-      nsectors = len / bch->sectsize;
-      if (sector + nsectors > bch->nsectors)
+      for (; nsectors > 0; nsectors--)
         {
-          nsectors = bch->nsectors - sector;
+          ret = bchlib_newsector(bch, sector);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          memcpy(BCH_SECTBUF(bch, sector), buffer, bch->sectsize);
+          bchlib_dirtysector(bch, sector);
+
+          sector++;
+          byteswritten += bch->sectsize;
+          buffer       += bch->sectsize;
+          len          -= bch->sectsize;
         }
 
-      /* Flush the dirty sector to keep the sector sequence */
+      if (sector >= bch->nsectors)
+        {
+          return byteswritten;
+        }
+    }
+
+  if (nsectors > 0)
+    {
+      /* If the sector buffer holds any of the sectors written below,
+       * write back its dirty sectors first and forget its content, so
+       * that it neither overwrites nor returns stale data later.
+       */
 
-      ret = bchlib_flushsector(bch, sector <= bch->sector &&
-                               bch->sector < (sector + nsectors));
+      ret = bchlib_syncsectors(bch, sector, nsectors, true);
       if (ret < 0)
         {
           ferr("ERROR: Flush failed: %d\n", ret);
@@ -224,8 +268,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       /* Copy the head end of the sector from the user buffer */
 
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      memcpy(BCH_SECTBUF(bch, sector), buffer, len);
+      bchlib_dirtysector(bch, sector);
 
       /* Adjust counts */
 
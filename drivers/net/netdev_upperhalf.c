@@ -241,7 +241,9 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
 
   if (quota <= 0 && lower->ops->reclaim)
     {
+      netdev_lock(&lower->netdev);
       lower->ops->reclaim(lower);
+      netdev_unlock(&lower->netdev);
       quota = netdev_lower_quota_load(lower, NETPKT_TX);
     }
 
@@ -299,7 +301,9 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
     }
   else
     {
+      netdev_lock(dev);
       ret = lower->ops->transmit(lower, pkt);
+      netdev_unlock(dev);
     }
 
   if (ret != OK)
@@ -583,6 +587,32 @@ static void ip_input(FAR struct net_driver_s *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: netdev_upper_receive
+ *
+ * Description:
+ *   Retrieve a received packet from the lower half driver.
+ *
+ * Input Parameters:
+ *   lower - Reference to the lower half driver structure
+ *
+ * Returned Value:
+ *   The packet received, or NULL if there are no more packets.
+ *
+ ****************************************************************************/
+
+static FAR netpkt_t *
+netdev_upper_receive(FAR struct netdev_lowerhalf_s *lower)
+{
+  FAR netpkt_t *pkt;
+
+  netdev_lock(&lower->netdev);
+  pkt = lower->ops->receive(lower);
+  netdev_unlock(&lower->netdev);
+
+  return pkt;
+}
+
 /****************************************************************************
  * Function: netdev_upper_rxpoll_work
  *
@@ -594,7 +624,8 @@ static void ip_input(FAR struct net_driver_s *dev)
  *   upper - Reference to the upper half driver structure
  *
  * Assumptions:
- *   Called with the network locked.
+ *   Called with the network locked, unless CONFIG_NET_FINE_GRAINED_LOCK is
+ *   enabled.  Then the network is only locked while a packet is processed.
  *
  ****************************************************************************/
 
@@ -606,7 +637,7 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
 
   /* Loop while receive() successfully retrieves valid Ethernet frames. */
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  while ((pkt = netdev_upper_receive(lower)) != NULL)
     {
       if (!IFF_IS_UP(dev->d_flags))
         {
@@ -617,6 +648,10 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           continue;
         }
 
+#ifdef CONFIG_NET_FINE_GRAINED_LOCK
+      net_lock();
+#endif
+
       netpkt_put(dev, pkt, NETPKT_RX);
       NETDEV_RXPACKETS(dev);
 
@@ -657,6 +692,10 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           nerr("Unknown link type %d\n", dev->d_lltype);
           break;
         }
+
+#ifdef CONFIG_NET_FINE_GRAINED_LOCK
+      net_unlock();
+#endif
     }
 }
 
@@ -677,8 +716,13 @@ static void netdev_upper_work(FAR void *arg)
 
   /* RX may release quota and driver buffer, so do RX first. */
 
+#ifdef CONFIG_NET_FINE_GRAINED_LOCK
+  netdev_upper_rxpoll_work(upper);
+  net_lock();
+#else
   net_lock();
   netdev_upper_rxpoll_work(upper);
+#endif
   netdev_upper_txavail_work(upper);
   net_unlock();
 }
@@ -1086,7 +1130,12 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 
   if (upper->lower->ops->ifup)
     {
-      return upper->lower->ops->ifup(upper->lower);
+      int ret;
+
+      netdev_lock(dev);
+      ret = upper->lower->ops->ifup(upper->lower);
+      netdev_unlock(dev);
+      return ret;
     }
 
   return -ENOSYS;
@@ -1102,7 +1151,12 @@ static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
 
   if (upper->lower->ops->ifdown)
     {
-      return upper->lower->ops->ifdown(upper->lower);
+      int ret;
+
+      netdev_lock(dev);
+      ret = upper->lower->ops->ifdown(upper->lower);
+      netdev_unlock(dev);
+      return ret;
     }
 
   return -ENOSYS;
@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <sys/mman.h>
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sched.h>
 #include <fcntl.h>
@@ -72,6 +74,10 @@
 #define get_task_state(s)                                                    \
   ((s) == 0 ? 'X' : ((s) <= LAST_READY_TO_RUN_STATE ? 'R' : 'S'))
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+#  define noteram_rings(drv) ((FAR struct noteram_ring_s *)(drv)->ni_buffer)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -119,8 +125,15 @@ static ssize_t noteram_read(FAR struct file *filep,
 static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 static int noteram_poll(FAR struct file *filep, FAR struct pollfd *fds,
                         bool setup);
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+static int noteram_mmap(FAR struct file *filep,
+                        FAR struct mm_map_entry_s *map);
+static void noteram_percpu_add(FAR struct note_driver_s *drv,
+                               FAR const void *note, size_t len);
+#else
 static void noteram_add(FAR struct note_driver_s *drv,
                         FAR const void *note, size_t len);
+#endif
 static void
 noteram_dump_init_context(FAR struct noteram_dump_context_s *ctx);
 static int noteram_dump_one(FAR uint8_t *p, FAR struct lib_outstream_s *s,
@@ -138,7 +151,11 @@ static const struct file_operations g_noteram_fops =
   NULL,          /* write */
   NULL,          /* seek */
   noteram_ioctl, /* ioctl */
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  noteram_mmap,  /* mmap */
+#else
   NULL,          /* mmap */
+#endif
   NULL,          /* truncate */
   noteram_poll,  /* poll */
 };
@@ -147,11 +164,18 @@ static
 #ifdef DRIVERS_NOTERAM_SECTION
 locate_data(DRIVERS_NOTERAM_SECTION)
 #endif
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+aligned_data(sizeof(uint32_t))
+#endif
 uint8_t g_ramnote_buffer[CONFIG_DRIVERS_NOTERAM_BUFSIZE];
 
 static const struct note_driver_ops_s g_noteram_ops =
 {
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  noteram_percpu_add
+#else
   noteram_add
+#endif
 };
 
 /****************************************************************************
@@ -203,8 +227,23 @@ struct noteram_driver_s g_noteram_driver =
 
 static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  FAR struct noteram_ring_s *ring = noteram_rings(drv);
+  int cpu;
+
+  /* The tail index belongs to the CPU adding notes, hide the notes behind
+   * the start index instead.
+   */
+
+  for (cpu = 0; cpu < NCPUS; cpu++, ring++)
+    {
+      ring->nr_start = ring->nr_head;
+      ring->nr_read  = ring->nr_start;
+    }
+#else
   drv->ni_tail = drv->ni_head;
   drv->ni_read = drv->ni_head;
+#endif
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
@@ -212,6 +251,8 @@ static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
     }
 }
 
+#ifndef CONFIG_DRIVERS_NOTERAM_PERCPU
+
 /****************************************************************************
  * Name: noteram_next
  *
@@ -420,6 +461,229 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
   return notelen;
 }
 
+#else /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
+/****************************************************************************
+ * Name: noteram_ring_copy
+ *
+ * Description:
+ *   Copy data out of a per-CPU ring, handling wraparound.
+ *
+ * Input Parameters:
+ *   drv  - The noteram driver
+ *   ring - The per-CPU ring
+ *   pos  - The free-running position of the data
+ *   dest - Location to return the data
+ *   len  - The length of the data
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void noteram_ring_copy(FAR struct noteram_driver_s *drv,
+                              FAR struct noteram_ring_s *ring,
+                              unsigned int pos, FAR void *dest, size_t len)
+{
+  FAR uint8_t *data = drv->ni_buffer + ring->nr_offset;
+  unsigned int ndx = pos & (ring->nr_size - 1);
+  size_t space = MIN(ring->nr_size - ndx, len);
+
+  memcpy(dest, data + ndx, space);
+  memcpy((FAR uint8_t *)dest + space, data, len - space);
+}
+
+/****************************************************************************
+ * Name: noteram_ring_oldest
+ *
+ * Description:
+ *   Return the position of the oldest note of a per-CPU ring that has not
+ *   been cleared.
+ *
+ ****************************************************************************/
+
+static unsigned int noteram_ring_oldest(FAR struct noteram_ring_s *ring)
+{
+  unsigned int tail = ring->nr_tail;
+  unsigned int start = ring->nr_start;
+
+  return (int)(start - tail) > 0 ? start : tail;
+}
+
+/****************************************************************************
+ * Name: noteram_percpu_init
+ *
+ * Description:
+ *   Split the note buffer into the ring descriptors and one ring per CPU.
+ *   The size of each ring is rounded down to a power of two.
+ *
+ ****************************************************************************/
+
+static void noteram_percpu_init(FAR struct noteram_driver_s *drv)
+{
+  FAR struct noteram_ring_s *ring = noteram_rings(drv);
+  size_t offset = NCPUS * sizeof(struct noteram_ring_s);
+  size_t size = 1;
+  int cpu;
+
+  DEBUGASSERT(drv->ni_bufsize >= offset + 2 * NCPUS);
+
+  while (size * 2 <= (drv->ni_bufsize - offset) / NCPUS)
+    {
+      size *= 2;
+    }
+
+  memset(ring, 0, offset);
+  for (cpu = 0; cpu < NCPUS; cpu++, ring++)
+    {
+      ring->nr_offset = offset + cpu * size;
+      ring->nr_size   = size;
+    }
+}
+
+/****************************************************************************
+ * Name: noteram_unread_length
+ *
+ * Description:
+ *   Length of unread data currently in the per-CPU rings.
+ *
+ ****************************************************************************/
+
+static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
+{
+  FAR struct noteram_ring_s *ring = noteram_rings(drv);
+  unsigned int length = 0;
+  unsigned int oldest;
+  unsigned int read;
+  int cpu;
+
+  for (cpu = 0; cpu < NCPUS; cpu++, ring++)
+    {
+      read   = ring->nr_read;
+      oldest = noteram_ring_oldest(ring);
+      if ((int)(oldest - read) > 0)
+        {
+          read = oldest;
+        }
+
+      length += ring->nr_head - read;
+    }
+
+  return length;
+}
+
+/****************************************************************************
+ * Name: noteram_get
+ *
+ * Description:
+ *   Get the oldest unread note of all per-CPU rings.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the next note
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   On success, the positive, non-zero length of the return note is
+ *   provided.  Zero is returned only if all rings are empty.  A negated
+ *   errno value is returned in the event of any failure.
+ *
+ * Assumptions:
+ *   The caller holds the driver spinlock, which serializes the readers.
+ *
+ ****************************************************************************/
+
+static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
+                           FAR uint8_t *buffer, size_t buflen)
+{
+  FAR struct noteram_ring_s *ring;
+  FAR struct noteram_ring_s *next;
+  struct note_common_s note;
+  clock_t systime = 0;
+  unsigned int oldest;
+  unsigned int read;
+  size_t notelen = 0;
+  int cpu;
+
+  DEBUGASSERT(buffer != NULL);
+
+retry:
+
+  /* Find the ring whose next note is the oldest one */
+
+  next = NULL;
+  ring = noteram_rings(drv);
+  for (cpu = 0; cpu < NCPUS; cpu++, ring++)
+    {
+      unsigned int head = ring->nr_head;
+
+      /* Notes that were overwritten before they could be read are lost */
+
+      UP_DMB();
+      read   = ring->nr_read;
+      oldest = noteram_ring_oldest(ring);
+      if ((int)(oldest - read) > 0)
+        {
+          read = oldest;
+          ring->nr_read = read;
+        }
+
+      if (read == head)
+        {
+          continue;
+        }
+
+      noteram_ring_copy(drv, ring, read, &note, sizeof(note));
+
+      /* The note may have been overwritten while it was being copied */
+
+      UP_DMB();
+      if ((int)(ring->nr_tail - read) > 0)
+        {
+          goto retry;
+        }
+
+      if (next == NULL || !clock_compare(systime, note.nc_systime))
+        {
+          next    = ring;
+          systime = note.nc_systime;
+          notelen = note.nc_length;
+        }
+    }
+
+  if (next == NULL)
+    {
+      return 0;
+    }
+
+  read = next->nr_read;
+
+  /* Is the user buffer large enough to hold the note? */
+
+  if (buflen < notelen)
+    {
+      /* Skip the large note so that we do not get constipated. */
+
+      next->nr_read = read + NOTE_ALIGN(notelen);
+
+      /* and return an error */
+
+      return -EFBIG;
+    }
+
+  noteram_ring_copy(drv, next, read, buffer, notelen);
+
+  UP_DMB();
+  if ((int)(next->nr_tail - read) > 0)
+    {
+      goto retry;
+    }
+
+  next->nr_read = read + NOTE_ALIGN(notelen);
+  return notelen;
+}
+
+#endif /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
 /****************************************************************************
  * Name: noteram_open
  ****************************************************************************/
@@ -429,10 +693,22 @@ static int noteram_open(FAR struct file *filep)
   FAR struct noteram_dump_context_s *ctx;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)
                                      filep->f_inode->i_private;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  FAR struct noteram_ring_s *ring = noteram_rings(drv);
+  int cpu;
+#endif
 
   /* Reset the read index of the circular buffer */
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  for (cpu = 0; cpu < NCPUS; cpu++, ring++)
+    {
+      ring->nr_read = noteram_ring_oldest(ring);
+    }
+#else
   drv->ni_read = drv->ni_tail;
+#endif
+
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -596,6 +872,34 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           }
         break;
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+      /* NOTERAM_GETLOST
+       *      - Get the number of notes lost before they were read
+       *        Argument: A writable pointer to unsigned long
+       */
+
+      case NOTERAM_GETLOST:
+        if (arg == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            FAR struct noteram_ring_s *ring = noteram_rings(drv);
+            unsigned long lost = 0;
+            int cpu;
+
+            for (cpu = 0; cpu < NCPUS; cpu++, ring++)
+              {
+                lost += ring->nr_lost;
+              }
+
+            *(FAR unsigned long *)arg = lost;
+            ret = OK;
+          }
+        break;
+#endif
+
       default:
           break;
     }
@@ -670,6 +974,8 @@ errout:
   return ret;
 }
 
+#ifndef CONFIG_DRIVERS_NOTERAM_PERCPU
+
 /****************************************************************************
  * Name: noteram_add
  *
@@ -741,6 +1047,146 @@ static void noteram_add(FAR struct note_driver_s *driver,
   poll_notify(&drv->pfd, 1, POLLIN);
 }
 
+#else /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
+/****************************************************************************
+ * Name: noteram_percpu_add
+ *
+ * Description:
+ *   Add the variable length note to the ring of the current CPU.  Only the
+ *   current CPU adds notes to that ring, so no lock is needed; readers
+ *   detect notes that were overwritten while they copied them.
+ *
+ * Input Parameters:
+ *   note    - The note buffer
+ *   notelen - The buffer length
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void noteram_percpu_add(FAR struct note_driver_s *driver,
+                               FAR const void *note, size_t notelen)
+{
+  FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_ring_s *ring;
+  FAR uint8_t *data;
+  unsigned int length = NOTE_ALIGN(notelen);
+  unsigned int oldest;
+  unsigned int head;
+  unsigned int ndx;
+  unsigned int space;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  ring = &noteram_rings(drv)[this_cpu()];
+
+  /* The rings are not set up before the driver is registered */
+
+  if (ring->nr_size == 0)
+    {
+      up_irq_restore(flags);
+      return;
+    }
+
+  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+    {
+      ring->nr_lost++;
+      up_irq_restore(flags);
+      return;
+    }
+
+  DEBUGASSERT(note != NULL && length < ring->nr_size);
+
+  head   = ring->nr_head;
+  oldest = noteram_ring_oldest(ring);
+
+  if (ring->nr_size - (head - oldest) <= length)
+    {
+      if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
+        {
+          /* Stop recording if not in overwrite mode */
+
+          drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
+          ring->nr_lost++;
+          up_irq_restore(flags);
+          return;
+        }
+
+      /* Drop the oldest notes until there is enough space, counting the
+       * ones that have not been read yet.
+       */
+
+      do
+        {
+          uint8_t len;
+
+          noteram_ring_copy(drv, ring, oldest, &len, 1);
+          if ((int)(oldest - ring->nr_read) >= 0)
+            {
+              ring->nr_lost++;
+            }
+
+          oldest += NOTE_ALIGN(len);
+        }
+      while (ring->nr_size - (head - oldest) <= length);
+
+      /* Let the readers know before the old notes are overwritten */
+
+      ring->nr_tail = oldest;
+      UP_DMB();
+    }
+
+  data  = drv->ni_buffer + ring->nr_offset;
+  ndx   = head & (ring->nr_size - 1);
+  space = MIN(ring->nr_size - ndx, notelen);
+  memcpy(data + ndx, note, space);
+  memcpy(data, (FAR const uint8_t *)note + space, notelen - space);
+
+  /* Publish the note only after it is complete */
+
+  UP_DMB();
+  ring->nr_head = head + length;
+  up_irq_restore(flags);
+
+  poll_notify(&drv->pfd, 1, POLLIN);
+}
+
+/****************************************************************************
+ * Name: noteram_mmap
+ *
+ * Description:
+ *   Map the note buffer, see struct noteram_ring_s for its layout.
+ *
+ ****************************************************************************/
+
+static int noteram_mmap(FAR struct file *filep,
+                        FAR struct mm_map_entry_s *map)
+{
+  FAR struct noteram_driver_s *drv = filep->f_inode->i_private;
+
+  if ((map->prot & PROT_WRITE) != 0)
+    {
+      return -EACCES;
+    }
+
+  if (map->offset >= 0 && map->offset < drv->ni_bufsize &&
+      map->length && map->offset + map->length <= drv->ni_bufsize)
+    {
+#ifdef CONFIG_BUILD_KERNEL
+      return -ENOTSUP;
+#else
+      map->vaddr = drv->ni_buffer + map->offset;
+      return OK;
+#endif
+    }
+
+  return -EINVAL;
+}
+
+#endif /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
 /****************************************************************************
  * Name: noteram_dump_init_context
  ****************************************************************************/
@@ -1312,6 +1758,9 @@ static void noteram_crash_dump_register(void)
 
 int noteram_register(void)
 {
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  noteram_percpu_init(&g_noteram_driver);
+#endif
 #ifdef CONFIG_DRIVERS_NOTERAM_CRASH_DUMP
   noteram_crash_dump_register();
 #endif
@@ -1347,15 +1796,15 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
 #endif
   int ret;
 
-  drv = kmm_malloc(sizeof(*drv) + len + bufsize);
+  drv = kmm_malloc(sizeof(*drv) + bufsize + len);
   if (drv == NULL)
     {
       return NULL;
     }
 #ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
 
-  memcpy(drv + 1, devpath, len);
-  drv->driver.name = (FAR const char *)(drv + 1);
+  memcpy((FAR uint8_t *)(drv + 1) + bufsize, devpath, len);
+  drv->driver.name = (FAR const char *)(drv + 1) + bufsize;
   drv->driver.filter.mode.flag =
                       CONFIG_SCHED_INSTRUMENTATION_FILTER_DEFAULT_MODE;
 
@@ -1368,12 +1817,15 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
 
   drv->driver.ops = &g_noteram_ops;
   drv->ni_bufsize = bufsize;
-  drv->ni_buffer = (FAR uint8_t *)(drv + 1) + len;
+  drv->ni_buffer = (FAR uint8_t *)(drv + 1);
   drv->ni_overwrite = overwrite;
   drv->ni_head = 0;
   drv->ni_tail = 0;
   drv->ni_read = 0;
   drv->pfd = NULL;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  noteram_percpu_init(drv);
+#endif
 
   ret = note_driver_register(&drv->driver);
   if (ret < 0)
@@ -31,6 +31,7 @@
 #include <sys/ioctl.h>
 #include <sys/param.h>
 #include <stdint.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,6 +44,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -64,6 +66,13 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+/* The largest piece that pipe_sendfile() writes out at a time.  The read
+ * lock is held while the piece is written, so other readers wait at most
+ * for one piece.
+ */
+
+#define PIPE_SENDFILE_CHUNK PIPE_BUF
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -76,6 +85,11 @@ static void pipecommon_wakeup(FAR sem_t *sem)
 {
   int sval;
 
+  /* Make the new buffer state visible before looking for waiters.  A
+   * waiter decrements the semaphore first and then rechecks the buffer.
+   */
+
+  UP_DMB();
   if (nxsem_get_value(sem, &sval) >= 0)
     {
       while (sval++ <= 0)
@@ -85,6 +99,204 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_pollnotify
+ *
+ * Description:
+ *   Notify the poll waiters of the pipe.  Readers and writers do not hold
+ *   d_bflock, so it is only taken if some poll has been set up.
+ *
+ ****************************************************************************/
+
+static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
+                                  pollevent_t eventset)
+{
+  /* Pairs with the barrier in pipecommon_poll():  Either the poll setup
+   * sees the new buffer state or the poller is seen here.
+   */
+
+  UP_DMB();
+  if (dev->d_npollers > 0 && nxrmutex_lock(&dev->d_bflock) >= 0)
+    {
+      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, eventset);
+      nxrmutex_unlock(&dev->d_bflock);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_ringread
+ *
+ * Description:
+ *   Read up to 'len' bytes from the circular buffer.  Must be called with
+ *   d_rdlock held.  Only the tail is moved, so this does not race with a
+ *   writer that concurrently moves the head.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_ringread(FAR struct circbuf_s *circ,
+                                  FAR char *buffer, size_t len)
+{
+  FAR void *src;
+  size_t nread = 0;
+  size_t n;
+
+  while (nread < len)
+    {
+      src = circbuf_get_readptr(circ, &n);
+      if (n == 0)
+        {
+          break;
+        }
+
+      n = MIN(n, len - nread);
+
+      /* Load the data only after the head that covers it, and release the
+       * space to the writer only after the data has been loaded.
+       */
+
+      UP_DMB();
+      memcpy(buffer + nread, src, n);
+      UP_DMB();
+
+      circbuf_readcommit(circ, n);
+      nread += n;
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_ringwrite
+ *
+ * Description:
+ *   Write up to 'len' bytes to the circular buffer.  Must be called with
+ *   d_wrlock held.  Only the head is moved, so this does not race with a
+ *   reader that concurrently moves the tail.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_ringwrite(FAR struct circbuf_s *circ,
+                                   FAR const char *buffer, size_t len)
+{
+  FAR void *dest;
+  size_t nwritten = 0;
+  size_t n;
+
+  while (nwritten < len && !circbuf_is_full(circ))
+    {
+      dest = circbuf_get_writeptr(circ, &n);
+      n    = MIN(n, len - nwritten);
+
+      /* Store the data only after the tail that freed the space, and
+       * publish it to the reader only after it has been stored.
+       */
+
+      UP_DMB();
+      memcpy(dest, buffer + nwritten, n);
+      UP_DMB();
+
+      circbuf_writecommit(circ, n);
+      nwritten += n;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitdata
+ *
+ * Description:
+ *   Wait until the buffer holds data.  Must be called with d_rdlock held,
+ *   which is released while waiting.
+ *
+ * Returned Value:
+ *   The number of bytes in the buffer with d_rdlock still held.  Zero on
+ *   end-of-file or a negated errno value on failure, with d_rdlock
+ *   released.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_waitdata(FAR struct pipe_dev_s *dev, int oflags)
+{
+  ssize_t nbytes;
+  int ret;
+
+  for (; ; )
+    {
+      nbytes = circbuf_used(&dev->d_buffer);
+      if (nbytes > 0)
+        {
+          return nbytes;
+        }
+
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          /* The last writer may have filled the buffer just before it
+           * closed the pipe.
+           */
+
+          UP_DMB();
+          if (!circbuf_is_empty(&dev->d_buffer))
+            {
+              continue;
+            }
+
+          nxrmutex_unlock(&dev->d_rdlock);
+          return 0;
+        }
+
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (oflags & O_NONBLOCK)
+        {
+          nxrmutex_unlock(&dev->d_rdlock);
+          return -EAGAIN;
+        }
+
+      /* Otherwise, wait for something to be written to the pipe */
+
+      nxrmutex_unlock(&dev->d_rdlock);
+      ret = nxsem_wait(&dev->d_rdsem);
+
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_rdlock)) < 0)
+        {
+          /* May fail because a signal was received or if the task was
+           * canceled.
+           */
+
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_readdone
+ *
+ * Description:
+ *   Notify the writers after data has been removed from the buffer.
+ *
+ ****************************************************************************/
+
+static void pipecommon_readdone(FAR struct pipe_dev_s *dev)
+{
+  /* Notify all poll/select waiters that they can write to the
+   * FIFO when buffer can accept more than d_polloutthrd bytes.
+   */
+
+  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
+    {
+      pipecommon_pollnotify(dev, POLLOUT);
+    }
+
+  /* Notify all waiting writers that bytes have been removed from the
+   * buffer.
+   */
+
+  pipecommon_wakeup(&dev->d_wrsem);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -107,6 +319,8 @@ FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize)
       /* Initialize the private structure */
 
       nxrmutex_init(&dev->d_bflock);
+      nxrmutex_init(&dev->d_rdlock);
+      nxrmutex_init(&dev->d_wrlock);
       nxsem_init(&dev->d_rdsem, 0, 0);
       nxsem_init(&dev->d_wrsem, 0, 0);
       dev->d_bufsize = bufsize;
@@ -122,6 +336,8 @@ FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize)
 void pipecommon_freedev(FAR struct pipe_dev_s *dev)
 {
   nxrmutex_destroy(&dev->d_bflock);
+  nxrmutex_destroy(&dev->d_rdlock);
+  nxrmutex_destroy(&dev->d_wrlock);
   nxsem_destroy(&dev->d_rdsem);
   nxsem_destroy(&dev->d_wrsem);
   kmm_free(dev);
@@ -426,9 +642,11 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return 0;
     }
 
-  /* Make sure that we have exclusive access to the device structure */
+  /* Make sure that we are the only reader.  The writers are not excluded,
+   * so with one reader and one writer neither ever waits for the other.
+   */
 
-  ret = nxrmutex_lock(&dev->d_bflock);
+  ret = nxrmutex_lock(&dev->d_rdlock);
   if (ret < 0)
     {
       /* May fail because a signal was received or if the task was
@@ -440,61 +658,20 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* If the pipe is empty, then wait for something to be written to it */
 
-  while (circbuf_is_empty(&dev->d_buffer))
+  nread = pipecommon_waitdata(dev, filep->f_oflags);
+  if (nread <= 0)
     {
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
-        {
-          nxrmutex_unlock(&dev->d_bflock);
-          return 0;
-        }
-
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          nxrmutex_unlock(&dev->d_bflock);
-          return -EAGAIN;
-        }
-
-      /* Otherwise, wait for something to be written to the pipe */
-
-      nxrmutex_unlock(&dev->d_bflock);
-      ret = nxsem_wait(&dev->d_rdsem);
-
-      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
-        {
-          /* May fail because a signal was received or if the task was
-           * canceled.
-           */
-
-          return ret;
-        }
+      return nread;
     }
 
   /* Then return whatever is available in the pipe (which is at least one
    * byte).
    */
 
-  nread = circbuf_read(&dev->d_buffer, buffer, len);
-
-  /* Notify all poll/select waiters that they can write to the
-   * FIFO when buffer can accept more than d_polloutthrd bytes.
-   */
+  nread = pipecommon_ringread(&dev->d_buffer, buffer, len);
+  pipecommon_readdone(dev);
 
-  if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
-    {
-      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
-    }
-
-  /* Notify all waiting writers that bytes have been removed from the
-   * buffer.
-   */
-
-  pipecommon_wakeup(&dev->d_wrsem);
-
-  nxrmutex_unlock(&dev->d_bflock);
+  nxrmutex_unlock(&dev->d_rdlock);
   pipe_dumpbuffer("From PIPE:", buffer, nread);
   return nread;
 }
@@ -537,9 +714,11 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   DEBUGASSERT(up_interrupt_context() == false);
 
-  /* Make sure that we have exclusive access to the device structure */
+  /* Make sure that we are the only writer.  The readers are not excluded,
+   * so with one reader and one writer neither ever waits for the other.
+   */
 
-  ret = nxrmutex_lock(&dev->d_bflock);
+  ret = nxrmutex_lock(&dev->d_wrlock);
   if (ret < 0)
     {
       /* May fail because a signal was received or if the task was
@@ -562,7 +741,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
       if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
         {
-          nxrmutex_unlock(&dev->d_bflock);
+          nxrmutex_unlock(&dev->d_wrlock);
           return nwritten == 0 ? -EPIPE : nwritten;
         }
 
@@ -572,8 +751,9 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
         {
           /* Loop until all of the bytes have been written */
 
-          nwritten += circbuf_write(&dev->d_buffer,
-                                    buffer + nwritten, len - nwritten);
+          nwritten += pipecommon_ringwrite(&dev->d_buffer,
+                                           buffer + nwritten,
+                                           len - nwritten);
 
           if ((size_t)nwritten == len)
             {
@@ -583,8 +763,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
               if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
                 {
-                  poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS,
-                              POLLIN);
+                  pipecommon_pollnotify(dev, POLLIN);
                 }
 
               /* Yes.. Notify all of the waiting readers that more data is
@@ -595,7 +774,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
               /* Return the number of bytes written */
 
-              nxrmutex_unlock(&dev->d_bflock);
+              nxrmutex_unlock(&dev->d_wrlock);
               return len;
             }
         }
@@ -611,7 +790,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
                * FIFO.
                */
 
-              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+              pipecommon_pollnotify(dev, POLLIN);
 
               /* Yes.. Notify all of the waiting readers that more data is
                * available.
@@ -633,7 +812,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
                   nwritten = -EAGAIN;
                 }
 
-              nxrmutex_unlock(&dev->d_bflock);
+              nxrmutex_unlock(&dev->d_wrlock);
               return nwritten;
             }
 
@@ -641,9 +820,9 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
            * the pipe
            */
 
-          nxrmutex_unlock(&dev->d_bflock);
+          nxrmutex_unlock(&dev->d_wrlock);
           ret = nxsem_wait(&dev->d_wrsem);
-          if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+          if (ret < 0 || (ret = nxrmutex_lock(&dev->d_wrlock)) < 0)
             {
               /* Either call nxsem_wait may fail because a signal was
                * received or if the task was canceled.
@@ -695,6 +874,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
               dev->d_fds[i] = fds;
               fds->priv     = &dev->d_fds[i];
+              dev->d_npollers++;
               break;
             }
         }
@@ -707,9 +887,11 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
         }
 
       /* Should immediately notify on any of the requested events?
-       * First, determine how many bytes are in the buffer
+       * First, determine how many bytes are in the buffer.  Pairs with
+       * the barrier in pipecommon_pollnotify().
        */
 
+      UP_DMB();
       nbytes = circbuf_used(&dev->d_buffer);
 
       /* Notify the POLLOUT event if the pipe buffer can accept
@@ -767,6 +949,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       *slot     = NULL;
       fds->priv = NULL;
+      dev->d_npollers--;
     }
 
 errout:
@@ -793,10 +976,32 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+  /* Peeking has to exclude the readers.  Resizing the buffer has to
+   * exclude the writers as well.
+   */
+
+  if (cmd == PIPEIOC_PEEK || cmd == PIPEIOC_SETSIZE)
+    {
+      ret = nxrmutex_lock(&dev->d_rdlock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (cmd == PIPEIOC_SETSIZE)
+    {
+      ret = nxrmutex_lock(&dev->d_wrlock);
+      if (ret < 0)
+        {
+          goto errout_with_rdlock;
+        }
+    }
+
   ret = nxrmutex_lock(&dev->d_bflock);
   if (ret < 0)
     {
-      return ret;
+      goto errout_with_wrlock;
     }
 
   switch (cmd)
@@ -909,9 +1114,127 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 
   nxrmutex_unlock(&dev->d_bflock);
+
+errout_with_wrlock:
+  if (cmd == PIPEIOC_SETSIZE)
+    {
+      nxrmutex_unlock(&dev->d_wrlock);
+    }
+
+errout_with_rdlock:
+  if (cmd == PIPEIOC_PEEK || cmd == PIPEIOC_SETSIZE)
+    {
+      nxrmutex_unlock(&dev->d_rdlock);
+    }
+
   return ret;
 }
 
+/****************************************************************************
+ * Name: pipe_sendfile
+ *
+ * Description:
+ *   Transfer up to 'count' bytes from a pipe or FIFO to 'outfile', writing
+ *   them straight from the circular buffer.  See include/nuttx/fs/fs.h.
+ *
+ ****************************************************************************/
+
+ssize_t pipe_sendfile(FAR struct file *outfile, FAR struct file *infile,
+                      size_t count)
+{
+  FAR struct inode      *inode = infile->f_inode;
+  FAR struct pipe_dev_s *dev;
+  FAR void              *src;
+  ssize_t                nsent = 0;
+  ssize_t                ret;
+  size_t                 n;
+
+  /* Pipes and FIFOs are the drivers that read with pipecommon_read() */
+
+  if (inode == NULL || !INODE_IS_DRIVER(inode) || inode->u.i_ops == NULL ||
+      inode->u.i_ops->read != pipecommon_read)
+    {
+      return -ENOSYS;
+    }
+
+  /* Writing a pipe into itself would wait for space that only this call
+   * can release.  Leave that to the copying fallback.
+   */
+
+  if (outfile->f_inode == inode)
+    {
+      return -ENOSYS;
+    }
+
+  if ((infile->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+
+  dev = inode->i_private;
+  DEBUGASSERT(dev);
+
+  ret = nxrmutex_lock(&dev->d_rdlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for data just like read() does */
+
+  ret = pipecommon_waitdata(dev, infile->f_oflags);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  /* Hand out what is in the buffer, one contiguous piece at a time.  The
+   * space is only released to the writers once it has been written out.
+   */
+
+  while ((size_t)nsent < count)
+    {
+      src = circbuf_get_readptr(&dev->d_buffer, &n);
+      if (n == 0)
+        {
+          break;
+        }
+
+      n = MIN(n, MIN(count - nsent, PIPE_SENDFILE_CHUNK));
+
+      UP_DMB();
+      ret = file_write(outfile, src, n);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      UP_DMB();
+      circbuf_readcommit(&dev->d_buffer, ret);
+      nsent += ret;
+      pipecommon_readdone(dev);
+
+      /* Stop if the output did not take everything */
+
+      if ((size_t)ret < n)
+        {
+          break;
+        }
+
+      /* Let the other readers have their turn between the pieces */
+
+      nxrmutex_unlock(&dev->d_rdlock);
+      ret = nxrmutex_lock(&dev->d_rdlock);
+      if (ret < 0)
+        {
+          return nsent;
+        }
+    }
+
+  nxrmutex_unlock(&dev->d_rdlock);
+  return nsent > 0 ? nsent : ret;
+}
+
 /****************************************************************************
  * Name: pipecommon_unlink
  ****************************************************************************/
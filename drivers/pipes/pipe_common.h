@@ -117,7 +117,9 @@ typedef uint8_t pipe_ndx_t;   /*  8-bit index */
 
 struct pipe_dev_s
 {
-  rmutex_t         d_bflock;      /* Used to serialize access to d_buffer and indices */
+  rmutex_t         d_bflock;      /* Used to serialize open, close, poll and ioctl */
+  rmutex_t         d_rdlock;      /* Used to serialize readers among themselves */
+  rmutex_t         d_wrlock;      /* Used to serialize writers among themselves */
   sem_t            d_rdsem;       /* Empty buffer - Reader waits for data write AND
                                    * block O_RDONLY open until there is at least one writer */
   sem_t            d_wrsem;       /* Full buffer - Writer waits for data read AND
@@ -128,8 +130,12 @@ struct pipe_dev_s
   uint8_t          d_nwriters;    /* Number of reference counts for write access */
   uint8_t          d_nreaders;    /* Number of reference counts for read access */
   uint8_t          d_flags;       /* See PIPE_FLAG_* definitions */
+  uint8_t          d_npollers;    /* Number of poll structures in d_fds */
   int16_t          d_crefs;       /* References to dev */
-  struct circbuf_s d_buffer;      /* Buffer allocated when device opened */
+  struct circbuf_s d_buffer;      /* Buffer allocated when device opened.
+                                   * The head is only moved by the writer
+                                   * holding d_wrlock and the tail only by
+                                   * the reader holding d_rdlock. */
 
   /* The following is a list if poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
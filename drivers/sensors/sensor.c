@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -37,11 +38,16 @@
 #include <poll.h>
 #include <fcntl.h>
 #include <nuttx/list.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/circbuf.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/sensors/sensor.h>
 #include <nuttx/lib/lib.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -102,6 +108,9 @@ struct sensor_user_s
   bool             flushing;   /* The is used to indicate user is flushing */
   sem_t            buffersem;  /* Wakeup user waiting for data in circular buffer */
   size_t           bufferpos;  /* The index of user generation in buffer */
+#ifdef CONFIG_SCHED_WORKQUEUE
+  clock_t          heldtime;   /* When the oldest unread sample arrived */
+#endif
 
   /* The subscriber info
    * Support multi advertisers to subscribe their own data when they
@@ -121,6 +130,14 @@ struct sensor_upperhalf_s
   struct circbuf_s   buffer;             /* The circular buffer of data */
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
+#ifdef CONFIG_SENSORS_SHARED_RING
+  FAR struct sensor_ring_s *ring;        /* The mapped header of buffers */
+  size_t             ringsize;           /* The size of the mapping */
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE
+  struct work_s      work;               /* Releases the held back samples */
+  clock_t            due;                /* When the work is due */
+#endif
 };
 
 /****************************************************************************
@@ -139,8 +156,15 @@ static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
+#ifdef CONFIG_SENSORS_SHARED_RING
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes);
+#ifdef CONFIG_SCHED_WORKQUEUE
+static void    sensor_wakeup_worker(FAR void *arg);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -228,7 +252,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_SHARED_RING
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -431,6 +459,40 @@ static bool sensor_is_updated(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+static bool sensor_is_pending(FAR struct sensor_upperhalf_s *upper,
+                              FAR struct sensor_user_s *user)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE
+  long delta;
+#endif
+
+  if (!sensor_is_updated(upper, user))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+  if (user->state.interval != UINT32_MAX && user->state.latency != 0)
+    {
+      /* The user accepts its samples up to 'latency' late, so hold the
+       * wakeup until the oldest unread sample is that old, by generation
+       * or by the clock, or until the samples start to be overwritten.
+       * sensor_wakeup() arms a work for the samples held back, so they
+       * are delivered even if no more samples are published.
+       */
+
+      delta = (long long)upper->state.generation - user->state.generation;
+      return delta >= (long long)user->state.latency ||
+             upper->timing.head / TIMING_BUF_ESIZE - user->bufferpos >=
+             upper->lower->nbuffer ||
+             clock_systime_ticks() - user->heldtime >=
+             USEC2TICK(user->state.latency);
+    }
+#endif
+
+  return true;
+}
+
 static void sensor_catch_up(FAR struct sensor_upperhalf_s *upper,
                             FAR struct sensor_user_s *user)
 {
@@ -569,6 +631,108 @@ static ssize_t sensor_do_samples(FAR struct sensor_upperhalf_s *upper,
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_SHARED_RING
+static int sensor_consume(FAR struct sensor_upperhalf_s *upper,
+                          FAR struct sensor_user_s *user, uint32_t pos)
+{
+  size_t head = upper->timing.head / TIMING_BUF_ESIZE;
+  size_t tail = upper->timing.tail / TIMING_BUF_ESIZE;
+  uint32_t generation;
+  uint32_t unread;
+
+  if (head == tail)
+    {
+      return pos == head ? OK : -EINVAL;
+    }
+
+  /* The index may be behind the ring if it was overwritten meanwhile, but
+   * must not be ahead of it.
+   */
+
+  unread = (uint32_t)head - pos;
+  if ((int32_t)unread < 0)
+    {
+      return -EINVAL;
+    }
+  else if (unread >= head - tail)
+    {
+      /* Nothing left in the ring was read yet */
+
+      user->bufferpos = tail;
+      circbuf_peekat(&upper->timing, tail * TIMING_BUF_ESIZE,
+                     &generation, TIMING_BUF_ESIZE);
+      user->state.generation = generation - 1;
+      return OK;
+    }
+
+  user->bufferpos = head - unread;
+  circbuf_peekat(&upper->timing, (user->bufferpos - 1) * TIMING_BUF_ESIZE,
+                 &generation, TIMING_BUF_ESIZE);
+  user->state.generation = generation;
+  return OK;
+}
+#endif
+
+static int sensor_init_buffer(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+#ifdef CONFIG_SENSORS_SHARED_RING
+  FAR struct sensor_ring_s *ring;
+  size_t timing;
+  size_t data;
+#else
+  int ret;
+#endif
+
+  if (circbuf_is_init(&upper->buffer))
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_SENSORS_SHARED_RING
+  /* Both circular buffers live in one block behind the header, so that
+   * they can be mapped together.
+   */
+
+  timing = sizeof(struct sensor_ring_s);
+  data = ALIGN_UP(timing + lower->nbuffer * TIMING_BUF_ESIZE,
+                  sizeof(uint64_t));
+  upper->ringsize = data + lower->nbuffer * upper->state.esize;
+  ring = kmm_zalloc(upper->ringsize);
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring->esize = upper->state.esize;
+  ring->nbuffer = lower->nbuffer;
+  ring->timing = timing;
+  ring->data = data;
+  circbuf_init(&upper->buffer, (FAR char *)ring + data,
+               lower->nbuffer * upper->state.esize);
+  circbuf_init(&upper->timing, (FAR char *)ring + timing,
+               lower->nbuffer * TIMING_BUF_ESIZE);
+  upper->ring = ring;
+#else
+  ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
+                     upper->state.esize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+      return ret;
+    }
+#endif
+
+  return OK;
+}
+
 static void sensor_pollnotify_one(FAR struct sensor_user_s *user,
                                   pollevent_t eventset,
                                   sensor_role_t role)
@@ -597,6 +761,68 @@ static void sensor_pollnotify(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+/* Wake the users whose samples are due, and arm the work for the earliest
+ * of the samples that are still held back.
+ */
+
+static void sensor_wakeup(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_user_s *user;
+#ifdef CONFIG_SCHED_WORKQUEUE
+  clock_t now = clock_systime_ticks();
+  clock_t due = 0;
+  bool held = false;
+#endif
+  int semcount;
+
+  list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
+    {
+      if (sensor_is_pending(upper, user))
+        {
+          nxsem_get_value(&user->buffersem, &semcount);
+          if (semcount < 1)
+            {
+              nxsem_post(&user->buffersem);
+            }
+
+          sensor_pollnotify_one(user, POLLIN, SENSOR_ROLE_RD);
+        }
+#ifdef CONFIG_SCHED_WORKQUEUE
+      else if (sensor_is_updated(upper, user))
+        {
+          clock_t userdue = user->heldtime + USEC2TICK(user->state.latency);
+
+          if (!held || (sclock_t)(userdue - due) < 0)
+            {
+              due = userdue;
+              held = true;
+            }
+        }
+#endif
+    }
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+  if (held && (work_available(&upper->work) ||
+               (sclock_t)(due - upper->due) < 0))
+    {
+      upper->due = due;
+      work_queue(LPWORK, &upper->work, sensor_wakeup_worker, upper,
+                 (sclock_t)(due - now) > 0 ? due - now : 0);
+    }
+#endif
+}
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+static void sensor_wakeup_worker(FAR void *arg)
+{
+  FAR struct sensor_upperhalf_s *upper = arg;
+
+  nxrmutex_lock(&upper->lock);
+  sensor_wakeup(upper);
+  nxrmutex_unlock(&upper->lock);
+}
+#endif
+
 static int sensor_open(FAR struct file *filep)
 {
   FAR struct inode *inode = filep->f_inode;
@@ -943,6 +1169,16 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_SENSORS_SHARED_RING
+      case SNIOC_CONSUME:
+        {
+          nxrmutex_lock(&upper->lock);
+          ret = sensor_consume(upper, user, arg1);
+          nxrmutex_unlock(&upper->lock);
+        }
+        break;
+#endif
+
       case SNIOC_GET_INFO:
         {
           if (lower->ops->get_info == NULL)
@@ -1063,7 +1299,7 @@ static int sensor_poll(FAR struct file *filep,
                 }
             }
         }
-      else if (sensor_is_updated(upper, user))
+      else if (sensor_is_pending(upper, user))
         {
           eventset |= POLLIN;
         }
@@ -1086,14 +1322,53 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_SHARED_RING
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  if ((map->prot & PROT_WRITE) != 0)
+    {
+      return -EACCES;
+    }
+
+  /* Sensors fetched on demand have no buffer to share */
+
+  if (lower->ops->fetch)
+    {
+      return -ENOTSUP;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  ret = sensor_init_buffer(upper);
+  if (ret >= 0)
+    {
+      if (map->offset >= 0 && map->offset < upper->ringsize &&
+          map->length && map->offset + map->length <= upper->ringsize)
+        {
+          map->vaddr = (FAR char *)upper->ring + map->offset;
+        }
+      else
+        {
+          ret = -EINVAL;
+        }
+    }
+
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
-  int semcount;
   int ret;
 
   nxrmutex_lock(&upper->lock);
@@ -1121,44 +1396,45 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
       return -EINVAL;
     }
 
-  if (!circbuf_is_init(&upper->buffer))
+  /* Initialize sensor buffer when data is first generated */
+
+  ret = sensor_init_buffer(upper);
+  if (ret < 0)
     {
-      /* Initialize sensor buffer when data is first generated */
+      nxrmutex_unlock(&upper->lock);
+      return ret;
+    }
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+#ifdef CONFIG_SCHED_WORKQUEUE
+  /* The latency of the users that have read everything starts now */
 
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
-      if (ret < 0)
+  list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
+    {
+      if (!sensor_is_updated(upper, user))
         {
-          circbuf_uninit(&upper->buffer);
-          nxrmutex_unlock(&upper->lock);
-          return ret;
+          user->heldtime = clock_systime_ticks();
         }
     }
+#endif
+
+#ifdef CONFIG_SENSORS_SHARED_RING
+  /* Tell the mapped readers which samples are about to be overwritten
+   * before touching them, and publish the new ones only once written.
+   */
+
+  upper->ring->reserve = upper->timing.head / TIMING_BUF_ESIZE + envcount;
+  UP_DMB();
+#endif
 
   circbuf_overwrite(&upper->buffer, data, bytes);
   sensor_generate_timing(upper, envcount);
-  list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
-    {
-      if (sensor_is_updated(upper, user))
-        {
-          nxsem_get_value(&user->buffersem, &semcount);
-          if (semcount < 1)
-            {
-              nxsem_post(&user->buffersem);
-            }
 
-          sensor_pollnotify_one(user, POLLIN, SENSOR_ROLE_RD);
-        }
-    }
+#ifdef CONFIG_SENSORS_SHARED_RING
+  UP_DMB();
+  upper->ring->head = upper->timing.head / TIMING_BUF_ESIZE;
+#endif
 
+  sensor_wakeup(upper);
   nxrmutex_unlock(&upper->lock);
   return bytes;
 }
@@ -1442,6 +1718,10 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
   sensor_rpmsg_unregister(lower);
 #endif
 
+#ifdef CONFIG_SCHED_WORKQUEUE
+  work_cancel_sync(LPWORK, &upper->work);
+#endif
+
   nxrmutex_destroy(&upper->lock);
   if (circbuf_is_init(&upper->buffer))
     {
@@ -1449,5 +1729,9 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
       circbuf_uninit(&upper->timing);
     }
 
+#ifdef CONFIG_SENSORS_SHARED_RING
+  kmm_free(upper->ring);
+#endif
+
   kmm_free(upper);
 }
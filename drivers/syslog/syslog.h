@@ -29,7 +29,36 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <stdbool.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The information about the caller that is printed in front of a message,
+ * as far as it is configured.
+ */
+
+struct syslog_context_s
+{
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;              /* Time the message was logged */
+#endif
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  FAR const char *name;            /* Name of the logging thread */
+#endif
+#ifdef CONFIG_SYSLOG_PROCESSID
+  pid_t pid;                       /* ID of the logging thread */
+#endif
+#ifdef CONFIG_SMP
+  uint8_t cpu;                     /* CPU the message was logged on */
+#endif
+  uint8_t priority;                /* Priority of the message */
+};
 
 /****************************************************************************
  * Public Data
@@ -250,6 +279,104 @@ void syslog_flush_intbuffer(bool force);
 
 ssize_t syslog_write_foreach(FAR const char *buffer,
                              size_t buflen, bool force);
+
+/****************************************************************************
+ * Name: syslog_getcontext
+ *
+ * Description:
+ *   Capture the information about the caller that is printed in front of a
+ *   message.
+ *
+ * Input Parameters:
+ *   ctx      - The location to return the information
+ *   priority - The priority of the message
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void syslog_getcontext(FAR struct syslog_context_s *ctx, int priority);
+
+/****************************************************************************
+ * Name: syslog_bprintf
+ *
+ * Description:
+ *   Output a message whose arguments were packed into a buffer in the
+ *   layout expected by lib_bsprintf().
+ *
+ * Input Parameters:
+ *   ctx - The information about the caller captured when it was logged
+ *   fmt - The format string of the message
+ *   buf - The packed arguments
+ *
+ * Returned Value:
+ *   The number of characters output.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_bprintf(FAR const struct syslog_context_s *ctx,
+                   FAR const IPTR char *fmt, FAR const void *buf);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_vprintf
+ *
+ * Description:
+ *   Queue a message in the ring of the current CPU without formatting it.
+ *   Only the format string pointer and the arguments are stored, the
+ *   syslog daemon formats the message later and writes it to the
+ *   channels.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   fmt      - The format string, which must stay valid until the message
+ *              is drained
+ *   ap       - The arguments of the format string
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was queued or dropped because the ring was
+ *   full.  A negated errno value if the message cannot be deferred and
+ *   must be output directly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred_vprintf(int priority, FAR const IPTR char *fmt,
+                            FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Start the syslog daemon that drains the deferred messages.  Messages
+ *   are output directly until this is done.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_deferred_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Format and output all pending deferred messages in the context of the
+ *   caller.  This is used by syslog_flush() when the system crashes and
+ *   the syslog daemon may never run again.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+void syslog_deferred_flush(void);
+#endif
+
 #endif /* CONFIG_SYSLOG */
 
 #undef EXTERN
@@ -0,0 +1,704 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <ctype.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The space for the packed arguments of one message.  Messages that need
+ * more are output directly.
+ */
+
+#define SYSLOG_ARGSIZE   128
+
+/* The size of the ring of each CPU */
+
+#define SYSLOG_RINGSIZE  CONFIG_SYSLOG_DEFERRED_BUFSIZE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The header of a message in a ring.  It is followed by the arguments,
+ * packed in the layout expected by lib_bsprintf().
+ */
+
+struct syslog_record_s
+{
+  uint16_t sr_length;                      /* Length including the header */
+  struct syslog_context_s sr_ctx;          /* Information about the caller */
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  char sr_name[CONFIG_TASK_NAME_SIZE + 1]; /* Copy of the thread name */
+#endif
+  FAR const IPTR char *sr_fmt;             /* The format string */
+};
+
+/* A message as it is built before it is queued and after it is removed */
+
+struct syslog_message_s
+{
+  struct syslog_record_s hdr;
+  uint8_t args[SYSLOG_ARGSIZE];
+};
+
+/* The ring of one CPU.  It is only filled by the CPU that owns it, with
+ * its interrupts disabled, so the producers need no lock.  It is drained
+ * by whoever holds g_syslog_draining.  One byte stays unused to tell a
+ * full ring from an empty one.
+ */
+
+struct syslog_ring_s
+{
+  volatile size_t head;              /* Where the next message is added */
+  volatile size_t tail;              /* Where the next message is removed */
+  volatile uint32_t ndropped;        /* Messages lost as the ring was full */
+  uint32_t nreported;                /* Drops that were already reported */
+  uint8_t buffer[SYSLOG_RINGSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+extern uint8_t _stext[];           /* Start of .text */
+extern uint8_t _etext[];           /* End_1 of .text + .rodata */
+
+static struct syslog_ring_s g_syslog_ring[CONFIG_SMP_NCPUS];
+
+/* The syslog daemon waits on g_syslog_sem while g_syslog_waiting is set */
+
+static sem_t g_syslog_sem = SEM_INITIALIZER(0);
+static atomic_t g_syslog_waiting;
+
+/* Serializes the consumers, i.e. the daemon and syslog_flush() */
+
+static atomic_t g_syslog_draining;
+
+/* Messages are output directly until the daemon is running */
+
+static bool g_syslog_started;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred_static
+ *
+ * Description:
+ *   Check if a format string can be referenced after the call returns.
+ *   Only strings in the text and read-only data of the image are known
+ *   to stay unchanged.  Strings in the heap, in writable static memory or
+ *   on a stack may be gone or overwritten when the message is formatted.
+ *
+ ****************************************************************************/
+
+static bool syslog_deferred_static(FAR const IPTR char *fmt)
+{
+  uintptr_t addr = (uintptr_t)fmt;
+
+  return addr >= (uintptr_t)_stext && addr < (uintptr_t)_etext;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_put
+ *
+ * Description:
+ *   Append one argument to the packed arguments.
+ *
+ ****************************************************************************/
+
+static bool syslog_deferred_put(FAR uint8_t *buf, FAR size_t *next,
+                                FAR const void *value, size_t size)
+{
+  if (*next + size > SYSLOG_ARGSIZE)
+    {
+      return false;
+    }
+
+  memcpy(buf + *next, value, size);
+  *next += size;
+  return true;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_pack
+ *
+ * Description:
+ *   Pack the arguments of a message the way lib_bsprintf() reads them back:
+ *   each argument unaligned with the size given by its conversion, and
+ *   strings copied including the terminator (or exactly as many bytes as
+ *   their precision).  The format is walked with the same rules that
+ *   lib_bsprintf() uses, anything it cannot reproduce is refused.
+ *
+ * Returned Value:
+ *   The size of the packed arguments on success.  -ENOTSUP if the format
+ *   cannot be deferred and -E2BIG if the arguments do not fit.
+ *
+ ****************************************************************************/
+
+static ssize_t syslog_deferred_pack(FAR uint8_t *buf,
+                                    FAR const IPTR char *fmt, va_list ap)
+{
+  FAR const IPTR char *prec = NULL;
+  bool infmt = false;
+  size_t next = 0;
+  size_t len = 0;
+  bool ok = true;
+  char c;
+
+  while ((c = *fmt++) != '\0')
+    {
+      if (!infmt)
+        {
+          if (c == '%')
+            {
+              prec  = NULL;
+              len   = 1;
+              infmt = true;
+            }
+
+          continue;
+        }
+
+      if (++len == 2 && c == '%')
+        {
+          infmt = false;
+        }
+      else if (c == 'c' || c == 'd' || c == 'i' || c == 'u' ||
+               c == 'o' || c == 'x' || c == 'X')
+        {
+          if (*(fmt - 2) == 'j')
+            {
+              intmax_t im = va_arg(ap, intmax_t);
+              ok = syslog_deferred_put(buf, &next, &im, sizeof(im));
+            }
+#ifdef CONFIG_HAVE_LONG_LONG
+          else if (*(fmt - 2) == 'l' && *(fmt - 3) == 'l')
+            {
+              long long ll = va_arg(ap, long long);
+              ok = syslog_deferred_put(buf, &next, &ll, sizeof(ll));
+            }
+#endif
+          else if (*(fmt - 2) == 'l')
+            {
+              long l;
+
+              if (c == 'c')
+                {
+                  return -ENOTSUP;
+                }
+
+              l  = va_arg(ap, long);
+              ok = syslog_deferred_put(buf, &next, &l, sizeof(l));
+            }
+          else if (*(fmt - 2) == 'z')
+            {
+              size_t sz = va_arg(ap, size_t);
+              ok = syslog_deferred_put(buf, &next, &sz, sizeof(sz));
+            }
+          else if (*(fmt - 2) == 't')
+            {
+              ptrdiff_t pd = va_arg(ap, ptrdiff_t);
+              ok = syslog_deferred_put(buf, &next, &pd, sizeof(pd));
+            }
+          else if (*(fmt - 2) == 'h' && *(fmt - 3) == 'h')
+            {
+              char ch = va_arg(ap, int);
+              ok = syslog_deferred_put(buf, &next, &ch, sizeof(ch));
+            }
+          else if (*(fmt - 2) == 'h')
+            {
+              short int si = va_arg(ap, int);
+              ok = syslog_deferred_put(buf, &next, &si, sizeof(si));
+            }
+          else
+            {
+              int i = va_arg(ap, int);
+              ok = syslog_deferred_put(buf, &next, &i, sizeof(i));
+            }
+
+          infmt = false;
+        }
+      else if (c == 'e' || c == 'f' || c == 'g' || c == 'a' ||
+               c == 'A' || c == 'E' || c == 'F' || c == 'G')
+        {
+#ifdef CONFIG_HAVE_DOUBLE
+          if (*(fmt - 2) == 'h')
+            {
+              float f = va_arg(ap, double);
+              ok = syslog_deferred_put(buf, &next, &f, sizeof(f));
+            }
+          else if (*(fmt - 2) == 'L')
+            {
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+              long double ld = va_arg(ap, long double);
+              ok = syslog_deferred_put(buf, &next, &ld, sizeof(ld));
+#  else
+              return -ENOTSUP;
+#  endif
+            }
+          else
+            {
+              double d = va_arg(ap, double);
+              ok = syslog_deferred_put(buf, &next, &d, sizeof(d));
+            }
+
+          infmt = false;
+#else
+          return -ENOTSUP;
+#endif
+        }
+      else if (c == 's')
+        {
+          FAR const char *str = va_arg(ap, FAR const char *);
+          size_t size;
+
+          /* Wide strings are not supported by lib_bsprintf() */
+
+          if (*(fmt - 2) == 'l')
+            {
+              return -ENOTSUP;
+            }
+
+          if (str == NULL)
+            {
+              str = "(null)";
+            }
+
+          if (prec != NULL)
+            {
+              size = strtol(prec, NULL, 10);
+              if (next + size > SYSLOG_ARGSIZE)
+                {
+                  return -E2BIG;
+                }
+
+              strncpy((FAR char *)buf + next, str, size);
+              next += size;
+            }
+          else
+            {
+              ok = syslog_deferred_put(buf, &next, str, strlen(str) + 1);
+            }
+
+          infmt = false;
+        }
+      else if (c == 'p')
+        {
+          FAR void *p;
+
+#ifdef CONFIG_LIBC_PRINT_EXTENSION
+          /* Extensions like %pV dereference the argument */
+
+          if (isalpha(*fmt))
+            {
+              return -ENOTSUP;
+            }
+#endif
+
+          p  = va_arg(ap, FAR void *);
+          ok = syslog_deferred_put(buf, &next, &p, sizeof(p));
+          infmt = false;
+        }
+      else if (c == '.')
+        {
+          prec = fmt;
+        }
+      else if (strchr("-+ #0123456789hljztL", c) == NULL || len > 16)
+        {
+          /* '*', '%n' or anything else that lib_bsprintf() does not
+           * handle.
+           */
+
+          return -ENOTSUP;
+        }
+
+      if (!ok)
+        {
+          return -E2BIG;
+        }
+    }
+
+  return next;
+}
+
+/****************************************************************************
+ * Name: syslog_ring_copyin
+ *
+ * Description:
+ *   Copy data into a ring at the given position, wrapping around at the
+ *   end of the buffer.
+ *
+ ****************************************************************************/
+
+static void syslog_ring_copyin(FAR struct syslog_ring_s *ring, size_t pos,
+                               FAR const void *data, size_t len)
+{
+  size_t part = SYSLOG_RINGSIZE - pos;
+
+  if (part >= len)
+    {
+      memcpy(&ring->buffer[pos], data, len);
+    }
+  else
+    {
+      memcpy(&ring->buffer[pos], data, part);
+      memcpy(ring->buffer, (FAR const uint8_t *)data + part, len - part);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_ring_copyout
+ *
+ * Description:
+ *   Copy data out of a ring from the given position, wrapping around at
+ *   the end of the buffer.
+ *
+ ****************************************************************************/
+
+static void syslog_ring_copyout(FAR struct syslog_ring_s *ring, size_t pos,
+                                FAR void *data, size_t len)
+{
+  size_t part = SYSLOG_RINGSIZE - pos;
+
+  if (part >= len)
+    {
+      memcpy(data, &ring->buffer[pos], len);
+    }
+  else
+    {
+      memcpy(data, &ring->buffer[pos], part);
+      memcpy((FAR uint8_t *)data + part, ring->buffer, len - part);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_drain
+ *
+ * Description:
+ *   Format and output the messages in all rings and report the messages
+ *   that were dropped.  The caller must hold g_syslog_draining.
+ *
+ ****************************************************************************/
+
+static void syslog_deferred_drain(void)
+{
+  FAR struct syslog_ring_s *ring;
+  struct syslog_message_s msg;
+  uint32_t ndropped;
+  size_t head;
+  size_t tail;
+  char buf[64];
+  int len;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      /* Stop at the messages that were there when we started, so that a
+       * busy CPU cannot hold up the others.
+       */
+
+      ring = &g_syslog_ring[cpu];
+      head = ring->head;
+      tail = ring->tail;
+
+      while (tail != head)
+        {
+          /* Read the message only after its head, and release its space
+           * only after it was read.
+           */
+
+          UP_DMB();
+
+          syslog_ring_copyout(ring, tail, &msg.hdr, sizeof(msg.hdr));
+          DEBUGASSERT(msg.hdr.sr_length >= sizeof(msg.hdr) &&
+                      msg.hdr.sr_length <= sizeof(msg));
+
+          syslog_ring_copyout(ring, (tail + sizeof(msg.hdr)) %
+                                    SYSLOG_RINGSIZE,
+                              msg.args, msg.hdr.sr_length - sizeof(msg.hdr));
+
+          tail = (tail + msg.hdr.sr_length) % SYSLOG_RINGSIZE;
+
+          UP_DMB();
+          ring->tail = tail;
+
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+          msg.hdr.sr_ctx.name = msg.hdr.sr_name;
+#endif
+
+          syslog_bprintf(&msg.hdr.sr_ctx, msg.hdr.sr_fmt, msg.args);
+        }
+
+      ndropped = ring->ndropped;
+      if (ndropped != ring->nreported)
+        {
+          len = snprintf(buf, sizeof(buf),
+                         "syslog: %" PRIu32 " messages dropped on CPU%d\n",
+                         ndropped - ring->nreported, cpu);
+          syslog_write(buf, len);
+          ring->nreported = ndropped;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_wakeup
+ *
+ * Description:
+ *   Wake up the syslog daemon if it waits for messages.
+ *
+ ****************************************************************************/
+
+static void syslog_deferred_wakeup(void)
+{
+  /* Pairs with the barrier in the daemon: either it sees the new head or
+   * we see that it waits.
+   */
+
+  UP_DMB();
+
+  if (atomic_read(&g_syslog_waiting) != 0 &&
+      atomic_xchg(&g_syslog_waiting, 0) != 0)
+    {
+      nxsem_post(&g_syslog_sem);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_daemon
+ *
+ * Description:
+ *   The syslog daemon drains the rings whenever messages were added.
+ *
+ ****************************************************************************/
+
+static int syslog_deferred_daemon(int argc, FAR char *argv[])
+{
+  for (; ; )
+    {
+      /* Announce the wait before draining, so that a message added after
+       * the rings were found empty posts the semaphore.
+       */
+
+      atomic_xchg(&g_syslog_waiting, 1);
+      UP_DMB();
+
+      if (atomic_xchg(&g_syslog_draining, 1) == 0)
+        {
+          syslog_deferred_drain();
+          atomic_set(&g_syslog_draining, 0);
+        }
+
+      nxsem_wait_uninterruptible(&g_syslog_sem);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_deferred_vprintf
+ *
+ * Description:
+ *   Queue a message in the ring of the current CPU without formatting it.
+ *   Only the format string pointer and the arguments are stored, the
+ *   syslog daemon formats the message later and writes it to the
+ *   channels.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   fmt      - The format string, which must stay valid until the message
+ *              is drained
+ *   ap       - The arguments of the format string
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was queued or dropped because the ring was
+ *   full.  A negated errno value if the message cannot be deferred and
+ *   must be output directly.
+ *
+ ****************************************************************************/
+
+int syslog_deferred_vprintf(int priority, FAR const IPTR char *fmt,
+                            FAR va_list *ap)
+{
+  FAR struct syslog_ring_s *ring;
+  struct syslog_message_s msg;
+  irqstate_t flags;
+  va_list copy;
+  ssize_t nargs;
+  size_t length;
+  size_t head;
+
+  /* Output directly until the OS and the daemon run and once the system
+   * crashed.
+   */
+
+  if (!g_syslog_started || !OSINIT_OS_READY() ||
+      g_nx_initstate >= OSINIT_PANIC)
+    {
+      return -EAGAIN;
+    }
+
+  if (!syslog_deferred_static(fmt))
+    {
+      return -ENOTSUP;
+    }
+
+  /* Pack the arguments on the stack, the caller still needs them if the
+   * message cannot be deferred.
+   */
+
+  va_copy(copy, *ap);
+  nargs = syslog_deferred_pack(msg.args, fmt, copy);
+  va_end(copy);
+
+  if (nargs < 0)
+    {
+      return nargs;
+    }
+
+  length = sizeof(msg.hdr) + nargs;
+  if (length >= SYSLOG_RINGSIZE)
+    {
+      return -E2BIG;
+    }
+
+  syslog_getcontext(&msg.hdr.sr_ctx, priority);
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  strlcpy(msg.hdr.sr_name, msg.hdr.sr_ctx.name, sizeof(msg.hdr.sr_name));
+#endif
+  msg.hdr.sr_length = length;
+  msg.hdr.sr_fmt    = fmt;
+
+  /* Only this CPU adds to its ring, so disabling the local interrupts is
+   * all it takes to own the head.
+   */
+
+  flags = up_irq_save();
+  ring  = &g_syslog_ring[this_cpu()];
+  head  = ring->head;
+
+  if ((ring->tail + SYSLOG_RINGSIZE - head - 1) % SYSLOG_RINGSIZE < length)
+    {
+      ring->ndropped++;
+    }
+  else
+    {
+      syslog_ring_copyin(ring, head, &msg, length);
+
+      /* Write the message before publishing it */
+
+      UP_DMB();
+      ring->head = (head + length) % SYSLOG_RINGSIZE;
+    }
+
+  up_irq_restore(flags);
+
+  syslog_deferred_wakeup();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_initialize
+ *
+ * Description:
+ *   Start the syslog daemon that drains the deferred messages.  Messages
+ *   are output directly until this is done.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int syslog_deferred_initialize(void)
+{
+  int pid;
+
+  pid = kthread_create("syslogd", CONFIG_SYSLOG_DEFERRED_PRIORITY,
+                       CONFIG_SYSLOG_DEFERRED_STACKSIZE,
+                       syslog_deferred_daemon, NULL);
+  if (pid < 0)
+    {
+      return pid;
+    }
+
+  g_syslog_started = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_deferred_flush
+ *
+ * Description:
+ *   Format and output all pending deferred messages in the context of the
+ *   caller.  This is used by syslog_flush() when the system crashes and
+ *   the syslog daemon may never run again.
+ *
+ ****************************************************************************/
+
+void syslog_deferred_flush(void)
+{
+  /* The daemon may have been stopped in the middle of a drain by the
+   * crash, so do not wait for it then.
+   */
+
+  if (atomic_xchg(&g_syslog_draining, 1) == 0 ||
+      g_nx_initstate >= OSINIT_PANIC)
+    {
+      syslog_deferred_drain();
+      atomic_set(&g_syslog_draining, 0);
+    }
+}
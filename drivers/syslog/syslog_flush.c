@@ -68,6 +68,12 @@ int syslog_flush(void)
 {
   int i;
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Format the messages that are still waiting for the syslog daemon */
+
+  syslog_deferred_flush();
+#endif
+
 #ifdef CONFIG_SYSLOG_INTBUFFER
   /* Flush any characters that may have been added to the interrupt
    * buffer.
@@ -65,86 +65,44 @@ static FAR const char * const g_priority_str[] =
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nx_vsyslog
+ * Name: syslog_prefix
  *
  * Description:
- *   nx_vsyslog() handles the system logging system calls. It is functionally
- *   equivalent to vsyslog() except that (1) the per-process priority
- *   filtering has already been performed and the va_list parameter is
- *   passed by reference.  That is because the va_list is a structure in
- *   some compilers and passing of structures in the NuttX sycalls does
- *   not work.
+ *   Output the information that precedes each message (timestamp, CPU,
+ *   thread ID, priority, ...) as configured.
  *
  ****************************************************************************/
 
-int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+static int syslog_prefix(FAR struct lib_outstream_s *stream,
+                         FAR const struct syslog_context_s *ctx)
 {
-  struct lib_syslograwstream_s stream;
   int ret = 0;
-#ifdef CONFIG_SYSLOG_PROCESS_NAME
-  FAR struct tcb_s *tcb = nxsched_self();
-#endif
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  struct timespec ts;
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+#if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   struct tm tm;
   char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
-#  endif
-#endif
-
-  /* Wrap the low-level output in a stream object and let lib_vsprintf
-   * do the work.
-   */
-
-  lib_syslograwstream_open(&stream);
-
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  ts.tv_sec = 0;
-  ts.tv_nsec = 0;
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   memset(&tm, 0, sizeof(tm));
-#  endif
 
-  /* Get the current time.  Since debug output may be generated very early
-   * in the start-up sequence, hardware timer support may not yet be
-   * available.
+  /* Since debug output may be generated very early in the start-up
+   * sequence, hardware timer support may not yet be available.
    */
 
   if (OSINIT_HW_READY())
     {
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
-      /* Use CLOCK_REALTIME if so configured */
-
-      clock_gettime(CLOCK_REALTIME, &ts);
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
+      localtime_r(&ctx->ts.tv_sec, &tm);
 #  else
-      /* Prefer monotonic when enabled, as it can be synchronized to
-       * RTC with clock_resynchronize.
-       */
-
-      clock_gettime(CLOCK_MONOTONIC, &ts);
-#  endif
-
-      /* Prepend the message with the current time, if available */
-
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-#    if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
-      localtime_r(&ts.tv_sec, &tm);
-#    else
-      gmtime_r(&ts.tv_sec, &tm);
-#    endif
+      gmtime_r(&ctx->ts.tv_sec, &tm);
 #  endif
     }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   date_buf[0] = '\0';
   strftime(date_buf, CONFIG_SYSLOG_TIMESTAMP_BUFFER,
            CONFIG_SYSLOG_TIMESTAMP_FORMAT, &tm);
-#  endif
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT) || defined(CONFIG_SYSLOG_TIMESTAMP) || \
@@ -152,7 +110,7 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
     defined(CONFIG_SYSLOG_PRIORITY) || defined(CONFIG_SYSLOG_PREFIX) || \
     defined(CONFIG_SYSLOG_PROCESS_NAME)
 
-  ret = lib_sprintf_internal(&stream.common,
+  ret = lib_sprintf_internal(stream,
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Reset the terminal style. */
 
@@ -206,36 +164,36 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_FORMAT_MICROSECOND)
-                             , date_buf, ts.tv_nsec / NSEC_PER_USEC
+                             , date_buf, ctx->ts.tv_nsec / NSEC_PER_USEC
 #    else
                              , date_buf
 #    endif
 #  else
-                             , (uintmax_t)ts.tv_sec
-                             , ts.tv_nsec / NSEC_PER_USEC
+                             , (uintmax_t)ctx->ts.tv_sec
+                             , ctx->ts.tv_nsec / NSEC_PER_USEC
 #  endif
 #endif
 
 #if defined(CONFIG_SMP)
-                             , this_cpu()
+                             , ctx->cpu
 #endif
 
 #if defined(CONFIG_SYSLOG_PROCESSID)
   /* Prepend the Thread ID */
 
-                             , nxsched_gettid()
+                             , ctx->pid
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Set the terminal style according to message priority. */
 
-                             , g_priority_color[priority]
+                             , g_priority_color[ctx->priority]
 #endif
 
 #if defined(CONFIG_SYSLOG_PRIORITY)
   /* Prepend the message priority. */
 
-                             , g_priority_str[priority]
+                             , g_priority_str[ctx->priority]
 #endif
 
 #if defined(CONFIG_SYSLOG_PREFIX)
@@ -247,28 +205,168 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_PROCESS_NAME
   /* Prepend the thread name */
 
-                             , get_task_name(tcb)
+                             , ctx->name
 #endif
                     );
 
 #endif /* CONFIG_SYSLOG_COLOR_OUTPUT || CONFIG_SYSLOG_TIMESTAMP || ... */
 
-  /* Generate the output */
+  return ret;
+}
 
-  ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
+/****************************************************************************
+ * Name: syslog_suffix
+ *
+ * Description:
+ *   Terminate the message with a newline if it does not already end with
+ *   one and reset the terminal style.
+ *
+ ****************************************************************************/
 
-  if (stream.last_ch != '\n')
+static int syslog_suffix(FAR struct lib_syslograwstream_s *stream)
+{
+  int ret = 0;
+
+  if (stream->last_ch != '\n')
     {
-      lib_stream_putc(&stream.common, '\n');
+      lib_stream_putc(&stream->common, '\n');
       ret++;
     }
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Reset the terminal style back to normal. */
 
-  ret += lib_stream_puts(&stream.common, "\e[0m", sizeof("\e[0m"));
+  ret += lib_stream_puts(&stream->common, "\e[0m", sizeof("\e[0m"));
 #endif
 
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_getcontext
+ *
+ * Description:
+ *   Capture the information about the caller that is printed in front of a
+ *   message.
+ *
+ ****************************************************************************/
+
+void syslog_getcontext(FAR struct syslog_context_s *ctx, int priority)
+{
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  ctx->ts.tv_sec  = 0;
+  ctx->ts.tv_nsec = 0;
+
+  /* Get the current time.  Since debug output may be generated very early
+   * in the start-up sequence, hardware timer support may not yet be
+   * available.
+   */
+
+  if (OSINIT_HW_READY())
+    {
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
+      /* Use CLOCK_REALTIME if so configured */
+
+      clock_gettime(CLOCK_REALTIME, &ctx->ts);
+#  else
+      /* Prefer monotonic when enabled, as it can be synchronized to
+       * RTC with clock_resynchronize.
+       */
+
+      clock_gettime(CLOCK_MONOTONIC, &ctx->ts);
+#  endif
+    }
+#endif
+
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+  ctx->name = get_task_name(nxsched_self());
+#endif
+#ifdef CONFIG_SYSLOG_PROCESSID
+  ctx->pid = nxsched_gettid();
+#endif
+#ifdef CONFIG_SMP
+  ctx->cpu = this_cpu();
+#endif
+  ctx->priority = priority;
+}
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+/****************************************************************************
+ * Name: syslog_bprintf
+ *
+ * Description:
+ *   Output a message whose arguments were packed into a buffer in the
+ *   layout expected by lib_bsprintf() when it was logged.  This is how
+ *   the deferred syslog finally formats the messages.
+ *
+ ****************************************************************************/
+
+int syslog_bprintf(FAR const struct syslog_context_s *ctx,
+                   FAR const IPTR char *fmt, FAR const void *buf)
+{
+  struct lib_syslograwstream_s stream;
+  int ret;
+
+  lib_syslograwstream_open(&stream);
+
+  ret  = syslog_prefix(&stream.common, ctx);
+  ret += lib_bsprintf(&stream.common, fmt, buf);
+  ret += syslog_suffix(&stream);
+
+  lib_syslograwstream_close(&stream);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: nx_vsyslog
+ *
+ * Description:
+ *   nx_vsyslog() handles the system logging system calls. It is functionally
+ *   equivalent to vsyslog() except that (1) the per-process priority
+ *   filtering has already been performed and the va_list parameter is
+ *   passed by reference.  That is because the va_list is a structure in
+ *   some compilers and passing of structures in the NuttX sycalls does
+ *   not work.
+ *
+ ****************************************************************************/
+
+int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  struct lib_syslograwstream_s stream;
+  struct syslog_context_s ctx;
+  int ret;
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Leave the formatting to the syslog daemon if possible.  The number of
+   * characters is not known then.
+   */
+
+  if (syslog_deferred_vprintf(priority, fmt, ap) >= 0)
+    {
+      return 0;
+    }
+#endif
+
+  syslog_getcontext(&ctx, priority);
+
+  /* Wrap the low-level output in a stream object and let lib_vsprintf
+   * do the work.
+   */
+
+  lib_syslograwstream_open(&stream);
+
+  ret  = syslog_prefix(&stream.common, &ctx);
+
+  /* Generate the output */
+
+  ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
+  ret += syslog_suffix(&stream);
+
   /* Flush and destroy the syslog stream buffer */
 
   lib_syslograwstream_close(&stream);
@@ -564,6 +564,8 @@ out:
  * Input Parameters:
  *   fs      - A reference to the file
  *   read    - True if get sectors for reading
+ *   buflen  - The number of bytes that will be written at ->f_pos.  The
+ *             clusters for all of them are allocated together.
  *
  * Output:
  *   ->ff_currentsector    - the sector index where ->f_pos is located
@@ -578,7 +580,8 @@ out:
  *
  ****************************************************************************/
 
-static int fat_get_sectors(FAR struct file *filep, bool read)
+static int fat_get_sectors(FAR struct file *filep, bool read,
+                           size_t buflen)
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct fat_mountpt_s *fs = inode->i_private;
@@ -700,7 +703,9 @@ static int fat_get_sectors(FAR struct file *filep, bool read)
 
   if (i == new_num_clu - 1)
     {
-      cluster = fat_extendchain(fs, cluster);
+      cluster = fat_extendrun(fs, cluster,
+                              DIV_ROUND_UP(filep->f_pos + buflen, clu_size) -
+                              i);
 
       if (cluster < 2 || cluster >= fs->fs_nclusters + 2)
         {
@@ -845,7 +850,7 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
     {
       bytesread  = 0;
 
-      ret = fat_get_sectors(filep, true);
+      ret = fat_get_sectors(filep, true, 0);
       if (ret < 0)
         {
           goto errout_with_lock;
@@ -1044,7 +1049,7 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 
   while (buflen > 0)
     {
-      ret = fat_get_sectors(filep, false);
+      ret = fat_get_sectors(filep, false, buflen);
       if (ret < 0)
         {
           goto errout_with_lock;
@@ -2326,6 +2331,13 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
         }
     }
 
+  /* Write back what is left in the sector cache */
+
+  if (fs->fs_mounted)
+    {
+      fat_fscacheflush(fs);
+    }
+
   /* Unmount ... close the block driver */
 
   if (fs->fs_blkdriver)
@@ -2353,8 +2365,13 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* Release the mountpoint private data */
 
+#ifdef CONFIG_FAT_FREEMAP
+  fat_freemapuninit(fs);
+#endif
+
   if (fs->fs_buffer)
     {
+      fat_fscacheuninit(fs);
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
@@ -43,6 +43,16 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+#ifndef CONFIG_FAT_FSCACHE_SECTORS
+#  define CONFIG_FAT_FSCACHE_SECTORS 0
+#endif
+
+#ifndef CONFIG_FAT_FSCACHE_READAHEAD
+#  define CONFIG_FAT_FSCACHE_READAHEAD 0
+#endif
+
 /****************************************************************************
  * These offsets describes the master boot record (MBR).
  *
@@ -862,6 +872,20 @@
  * is mounted with a fat32 filesystem.
  */
 
+/* One sector of the LRU sector cache of a mountpoint.  The cache holds
+ * recently used FAT and directory sectors besides the one in fs_buffer.
+ */
+
+#if CONFIG_FAT_FSCACHE_SECTORS > 0
+struct fat_cache_s
+{
+  off_t    fc_sector;              /* The cached sector, -1 if unused */
+  uint32_t fc_lru;                 /* Time of last use, see fs_cachelru */
+  bool     fc_dirty;               /* true: fc_buffer is dirty */
+  uint8_t *fc_buffer;              /* The sector data */
+};
+#endif
+
 struct fat_file_s;
 struct fat_mountpt_s
 {
@@ -891,6 +915,16 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#if CONFIG_FAT_FSCACHE_SECTORS > 0
+  uint32_t fs_cachelru;            /* Incremented on each use of fs_cache */
+#  if CONFIG_FAT_FSCACHE_READAHEAD > 0
+  uint8_t *fs_rabuffer;            /* Holds the sectors read ahead */
+#  endif
+  struct fat_cache_s fs_cache[CONFIG_FAT_FSCACHE_SECTORS];
+#endif
+#ifdef CONFIG_FAT_FREEMAP
+  uint32_t *fs_freemap;            /* One bit per cluster, set if free */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -1053,6 +1087,9 @@ EXTERN int    fat_removechain(FAR struct fat_mountpt_s *fs,
 EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
                                uint32_t cluster);
 
+EXTERN int32_t fat_extendrun(FAR struct fat_mountpt_s *fs,
+                             uint32_t cluster, uint32_t nclusters);
+
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
 /* Help for traversing directory trees and accessing directory entries */
@@ -1091,6 +1128,8 @@ EXTERN int    fat_remove(FAR struct fat_mountpt_s *fs,
 
 /* Mountpoint and file buffer cache (for partial sector accesses) */
 
+EXTERN int    fat_fscacheinit(FAR struct fat_mountpt_s *fs);
+EXTERN void   fat_fscacheuninit(FAR struct fat_mountpt_s *fs);
 EXTERN int    fat_fscacheflush(FAR struct fat_mountpt_s *fs);
 EXTERN int    fat_fscacheread(FAR struct fat_mountpt_s *fs, off_t sector);
 EXTERN int    fat_ffcacheflush(FAR struct fat_mountpt_s *fs,
@@ -1106,6 +1145,9 @@ EXTERN int    fat_updatefsinfo(FAR struct fat_mountpt_s *fs);
 EXTERN int    fat_computefreeclusters(FAR struct fat_mountpt_s *fs);
 EXTERN int    fat_nfreeclusters(FAR struct fat_mountpt_s *fs,
                                 FAR fsblkcnt_t *pfreeclusters);
+#ifdef CONFIG_FAT_FREEMAP
+EXTERN void   fat_freemapuninit(FAR struct fat_mountpt_s *fs);
+#endif
 EXTERN int    fat_currentsector(FAR struct fat_mountpt_s *fs,
                                 FAR struct fat_file_s *ff, off_t position);
 
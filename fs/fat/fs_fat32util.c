@@ -32,6 +32,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
 #include <assert.h>
 #include <errno.h>
@@ -44,6 +45,17 @@
 #include "inode/inode.h"
 #include "fs_fat32.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of the free cluster map in words.  Cluster numbers are used as bit
+ * indices, so the bits of the reserved clusters 0 and 1 are never set.
+ */
+
+#define FREEMAP_NWORDS(fs)  (((fs)->fs_nclusters + 2 + 31) >> 5)
+#define FREEMAP_BIT(c)      (UINT32_C(1) << ((c) & 31))
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -203,71 +215,829 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
                  ntotalfatsects - rootdirsectors;
   if (ndatasectors > fs->fs_hwnsectors)
     {
-      fwarn("WARNING: ndatasectors %" PRId32
-            " fs_hwnsectors: %" PRIdOFF "\n",
-            ndatasectors, fs->fs_hwnsectors);
+      fwarn("WARNING: ndatasectors %" PRId32
+            " fs_hwnsectors: %" PRIdOFF "\n",
+            ndatasectors, fs->fs_hwnsectors);
+
+      return -EINVAL;
+    }
+
+  /* Get the sectors per cluster */
+
+  fs->fs_fatsecperclus = FBR_GETSECPERCLUS(fs->fs_buffer);
+  if (fs->fs_fatsecperclus == 0)
+    {
+      fwarn("WARNING: sectors per cluster cannot be 0\n");
+      return -EINVAL;
+    }
+
+  /* Calculate the number of clusters */
+
+  fs->fs_nclusters = ndatasectors / fs->fs_fatsecperclus;
+
+  /* Finally, the test: */
+
+  if (fs->fs_nclusters <= FAT_MAXCLUST12)
+    {
+      fs->fs_fsinfo = 0;
+      fs->fs_type   = FSTYPE_FAT12;
+    }
+  else if (fs->fs_nclusters <= FAT_MAXCLUST16)
+    {
+      fs->fs_fsinfo = 0;
+      fs->fs_type   = FSTYPE_FAT16;
+    }
+  else if (!notfat32)
+    {
+      fs->fs_fsinfo = fs->fs_fatbase + FBR_GETFSINFO(fs->fs_buffer);
+      fs->fs_type   = FSTYPE_FAT32;
+    }
+  else
+    {
+      fwarn("WARNING: notfat32: %d fs_nclusters: %" PRId32 "\n",
+            notfat32, fs->fs_nclusters);
+
+      return -EINVAL;
+    }
+
+  /* We have what appears to be a valid FAT filesystem! Save a few more
+   * things from the boot record that we will need later.
+   */
+
+  fs->fs_fatbase     += fs->fs_fatresvdseccount;
+
+  if (fs->fs_type == FSTYPE_FAT32)
+    {
+      fs->fs_rootbase = FBR_GETROOTCLUS(fs->fs_buffer);
+    }
+  else
+    {
+      fs->fs_rootbase = fs->fs_fatbase + ntotalfatsects;
+    }
+
+  fs->fs_database     = fs->fs_fatbase + ntotalfatsects + fs->fs_rootentcnt /
+                        DIRSEC_NDIRS(fs);
+  fs->fs_fsifreecount = 0xffffffff;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_blkread
+ *
+ * Description:
+ *   Read sectors from the block driver
+ *
+ ****************************************************************************/
+
+static int fat_blkread(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                       off_t sector, unsigned int nsectors)
+{
+  int ret = -ENODEV;
+  if (fs && fs->fs_blkdriver)
+    {
+      struct inode *inode = fs->fs_blkdriver;
+      if (inode && inode->u.i_bops && inode->u.i_bops->read)
+        {
+          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
+                                                       sector, nsectors);
+          if (nsectorsread == nsectors)
+            {
+              ret = OK;
+            }
+          else if (nsectorsread < 0)
+            {
+              ret = nsectorsread;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_blkwrite
+ *
+ * Description:
+ *   Write sectors to the block driver
+ *
+ ****************************************************************************/
+
+static int fat_blkwrite(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
+                        off_t sector, unsigned int nsectors)
+{
+  int ret = -ENODEV;
+  if (fs && fs->fs_blkdriver)
+    {
+      struct inode *inode = fs->fs_blkdriver;
+      if (inode && inode->u.i_bops && inode->u.i_bops->write)
+        {
+          ssize_t nsectorswritten =
+              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+
+          if (nsectorswritten == nsectors)
+            {
+              ret = OK;
+            }
+          else if (nsectorswritten < 0)
+            {
+              ret = nsectorswritten;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: fat_fscachewrite
+ *
+ * Description:
+ *   Write a cached sector back to the device.  A sector of the FAT region
+ *   is written to all copies of the FAT.
+ *
+ ****************************************************************************/
+
+static int fat_fscachewrite(FAR struct fat_mountpt_s *fs,
+                            FAR uint8_t *buffer, off_t sector)
+{
+  int ret;
+  int i;
+
+  ret = fat_blkwrite(fs, buffer, sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Does the sector lie in the FAT region? */
+
+  if (sector >= fs->fs_fatbase &&
+      sector < fs->fs_fatbase + fs->fs_nfatsects)
+    {
+      /* Yes, then make the change in the FAT copy as well */
+
+      for (i = fs->fs_fatnumfats; i >= 2; i--)
+        {
+          sector += fs->fs_nfatsects;
+          ret = fat_blkwrite(fs, buffer, sector, 1);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+#if CONFIG_FAT_FSCACHE_SECTORS > 0
+
+/****************************************************************************
+ * Name: fat_fscachestale
+ *
+ * Description:
+ *   Return true if the cache entry holds an outdated copy of the sector in
+ *   fs_buffer.  This happens when fs_currentsector is assigned without
+ *   fat_fscacheread() in order to build a new sector from scratch.  The
+ *   entry is released.
+ *
+ ****************************************************************************/
+
+static bool fat_fscachestale(FAR struct fat_mountpt_s *fs,
+                             FAR struct fat_cache_s *entry)
+{
+  if (entry->fc_sector >= 0 && entry->fc_sector == fs->fs_currentsector)
+    {
+      entry->fc_sector = -1;
+      entry->fc_dirty  = false;
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: fat_fscachefind
+ *
+ * Description:
+ *   Return the cache entry that holds 'sector', or NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct fat_cache_s *
+fat_fscachefind(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_FSCACHE_SECTORS; i++)
+    {
+      if (fs->fs_cache[i].fc_sector == sector)
+        {
+          return &fs->fs_cache[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: fat_fscacheevict
+ *
+ * Description:
+ *   Release the least recently used cache entry, or an unused one, and
+ *   return it in 'victim'.  A dirty sector is written back first.
+ *
+ ****************************************************************************/
+
+static int fat_fscacheevict(FAR struct fat_mountpt_s *fs,
+                            FAR struct fat_cache_s **victim)
+{
+  FAR struct fat_cache_s *entry;
+  FAR struct fat_cache_s *lru = NULL;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_FSCACHE_SECTORS; i++)
+    {
+      entry = &fs->fs_cache[i];
+      if (entry->fc_sector < 0)
+        {
+          lru = entry;
+          break;
+        }
+
+      if (lru == NULL || (int32_t)(entry->fc_lru - lru->fc_lru) < 0)
+        {
+          lru = entry;
+        }
+    }
+
+  if (lru->fc_sector >= 0 && lru->fc_dirty)
+    {
+      ret = fat_fscachewrite(fs, lru->fc_buffer, lru->fc_sector);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  lru->fc_sector = -1;
+  lru->fc_dirty  = false;
+  *victim        = lru;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscacheswap
+ *
+ * Description:
+ *   Exchange the contents of two sector buffers.
+ *
+ ****************************************************************************/
+
+static void fat_fscacheswap(FAR uint8_t *buf1, FAR uint8_t *buf2,
+                            size_t len)
+{
+  FAR uint32_t *ptr1 = (FAR uint32_t *)buf1;
+  FAR uint32_t *ptr2 = (FAR uint32_t *)buf2;
+  uint32_t tmp;
+
+  for (len /= sizeof(uint32_t); len > 0; len--)
+    {
+      tmp     = *ptr1;
+      *ptr1++ = *ptr2;
+      *ptr2++ = tmp;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_fscachefill
+ *
+ * Description:
+ *   Read 'sector' into fs_buffer.  If it is a sector of the FAT, also read
+ *   the following FAT sectors into the cache with the same request, as
+ *   cluster chains are mostly followed forward.
+ *
+ ****************************************************************************/
+
+static int fat_fscachefill(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+#if CONFIG_FAT_FSCACHE_READAHEAD > 0
+  FAR struct fat_cache_s *entry;
+  off_t fatend = fs->fs_fatbase + fs->fs_nfatsects;
+  unsigned int nahead = 0;
+  unsigned int i;
+  int ret;
+
+  if (sector >= fs->fs_fatbase && sector < fatend)
+    {
+      /* Stop at the first sector that is cached already.  Keep the entry
+       * that just received the previous fs_buffer.
+       */
+
+      while (nahead < CONFIG_FAT_FSCACHE_READAHEAD &&
+             nahead < CONFIG_FAT_FSCACHE_SECTORS - 1 &&
+             sector + 1 + nahead < fatend &&
+             fat_fscachefind(fs, sector + 1 + nahead) == NULL)
+        {
+          nahead++;
+        }
+    }
+
+  if (nahead > 0)
+    {
+      ret = fat_blkread(fs, fs->fs_rabuffer, sector, nahead + 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      memcpy(fs->fs_buffer, fs->fs_rabuffer, fs->fs_hwsectorsize);
+
+      for (i = 1; i <= nahead; i++)
+        {
+          /* The read-ahead is just a hint; give up on any error */
+
+          if (fat_fscacheevict(fs, &entry) < 0)
+            {
+              break;
+            }
+
+          memcpy(entry->fc_buffer,
+                 &fs->fs_rabuffer[i * fs->fs_hwsectorsize],
+                 fs->fs_hwsectorsize);
+          entry->fc_sector = sector + i;
+          entry->fc_lru    = ++fs->fs_cachelru;
+        }
+
+      return OK;
+    }
+#endif
+
+  return fat_blkread(fs, fs->fs_buffer, sector, 1);
+}
+
+/****************************************************************************
+ * Name: fat_fscachesync
+ *
+ * Description:
+ *   Write back the dirty cached copies of the given sectors, so that they
+ *   can be read from the device.
+ *
+ ****************************************************************************/
+
+static int fat_fscachesync(FAR struct fat_mountpt_s *fs, off_t sector,
+                           unsigned int nsectors)
+{
+  FAR struct fat_cache_s *entry;
+  int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_FSCACHE_SECTORS; i++)
+    {
+      entry = &fs->fs_cache[i];
+      if (entry->fc_dirty && entry->fc_sector >= sector &&
+          entry->fc_sector < sector + nsectors &&
+          !fat_fscachestale(fs, entry))
+        {
+          ret = fat_fscachewrite(fs, entry->fc_buffer, entry->fc_sector);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          entry->fc_dirty = false;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_fscacheinval
+ *
+ * Description:
+ *   Drop the cached copies of sectors that are about to be overwritten.
+ *
+ ****************************************************************************/
+
+static void fat_fscacheinval(FAR struct fat_mountpt_s *fs, off_t sector,
+                             unsigned int nsectors)
+{
+  FAR struct fat_cache_s *entry;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_FSCACHE_SECTORS; i++)
+    {
+      entry = &fs->fs_cache[i];
+      if (entry->fc_sector >= sector &&
+          entry->fc_sector < sector + nsectors)
+        {
+          entry->fc_sector = -1;
+          entry->fc_dirty  = false;
+        }
+    }
+}
+#endif /* CONFIG_FAT_FSCACHE_SECTORS > 0 */
+
+/****************************************************************************
+ * Name: fat_scanfreeclusters
+ *
+ * Description:
+ *   Count the free clusters in the FAT.  If 'freemap' is not NULL, the bits
+ *   of the free clusters are also set in it.
+ *
+ ****************************************************************************/
+
+static int fat_scanfreeclusters(FAR struct fat_mountpt_s *fs,
+                                FAR uint32_t *freemap,
+                                FAR uint32_t *pnfreeclusters)
+{
+  uint32_t nfreeclusters = 0;
+
+  if (fs->fs_type == FSTYPE_FAT12)
+    {
+      off_t sector;
+
+      /* Examine every cluster in the fat */
+
+      for (sector = 2; sector < fs->fs_nclusters + 2; sector++)
+        {
+          /* If the cluster is unassigned, then increment the count of free
+           * clusters
+           */
+
+          if ((uint16_t)fat_getcluster(fs, sector) == 0)
+            {
+              nfreeclusters++;
+              if (freemap != NULL)
+                {
+                  freemap[sector >> 5] |= FREEMAP_BIT(sector);
+                }
+            }
+        }
+    }
+  else
+    {
+      unsigned int cluster;
+      off_t        fatsector;
+      unsigned int offset;
+      uint32_t     value;
+      int          ret;
+
+      fatsector    = fs->fs_fatbase;
+      offset       = fs->fs_hwsectorsize;
+
+      /* Examine each cluster in the fat.  The FAT starts with the entries
+       * of the reserved clusters 0 and 1, which are never free.
+       */
+
+      for (cluster = 0; cluster < fs->fs_nclusters + 2; cluster++)
+        {
+          /* If we are starting a new sector, then read the new sector in
+           * fs_buffer
+           */
+
+          if (offset >= fs->fs_hwsectorsize)
+            {
+              ret = fat_fscacheread(fs, fatsector);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              /* Reset the offset to the next FAT entry.
+               * Increment the sector number to read next time around.
+               */
+
+              offset = 0;
+              fatsector++;
+            }
+
+          /* FAT16 and FAT32 differ only on the size of each cluster start
+           * sector number in the FAT.
+           */
+
+          if (fs->fs_type == FSTYPE_FAT16)
+            {
+              value   = FAT_GETFAT16(fs->fs_buffer, offset);
+              offset += 2;
+            }
+          else
+            {
+              value   = FAT_GETFAT32(fs->fs_buffer, offset) & 0x0fffffff;
+              offset += 4;
+            }
+
+          if (value == 0 && cluster >= 2)
+            {
+              nfreeclusters++;
+              if (freemap != NULL)
+                {
+                  freemap[cluster >> 5] |= FREEMAP_BIT(cluster);
+                }
+            }
+        }
+    }
+
+  *pnfreeclusters = nfreeclusters;
+  return OK;
+}
+
+#ifdef CONFIG_FAT_FREEMAP
+/****************************************************************************
+ * Name: fat_freemapinit
+ *
+ * Description:
+ *   Build the map of free clusters if there is none yet.  The volume is
+ *   used without the map if there is not enough memory for it.
+ *
+ ****************************************************************************/
+
+static void fat_freemapinit(FAR struct fat_mountpt_s *fs)
+{
+  FAR uint32_t *freemap;
+  uint32_t nfreeclusters;
+
+  if (fs->fs_freemap != NULL)
+    {
+      return;
+    }
+
+  freemap = fs_heap_zalloc(FREEMAP_NWORDS(fs) * sizeof(uint32_t));
+  if (freemap == NULL)
+    {
+      return;
+    }
+
+  if (fat_scanfreeclusters(fs, freemap, &nfreeclusters) < 0)
+    {
+      fs_heap_free(freemap);
+      return;
+    }
+
+  /* Take the opportunity to correct the free cluster count */
+
+  fs->fs_freemap      = freemap;
+  fs->fs_fsifreecount = nfreeclusters;
+  if (fs->fs_type == FSTYPE_FAT32)
+    {
+      fs->fs_fsidirty = true;
+    }
+}
+
+/****************************************************************************
+ * Name: fat_freemapfind
+ *
+ * Description:
+ *   Return the first free cluster in the range from 'start' up to (but not
+ *   including) 'end', or zero if there is none.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemapfind(FAR struct fat_mountpt_s *fs,
+                                uint32_t start, uint32_t end)
+{
+  uint32_t word;
+
+  while (start < end)
+    {
+      word = fs->fs_freemap[start >> 5] >> (start & 31);
+      if (word != 0)
+        {
+          start += ffs(word) - 1;
+          return start < end ? start : 0;
+        }
+
+      start = (start | 31) + 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: fat_freemaprun
+ *
+ * Description:
+ *   Return the number of consecutive free clusters starting at 'cluster',
+ *   counting no further than 'nclusters'.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemaprun(FAR struct fat_mountpt_s *fs,
+                               uint32_t cluster, uint32_t nclusters)
+{
+  uint32_t end = fs->fs_nclusters + 2;
+  uint32_t n;
+
+  if (nclusters > end - cluster)
+    {
+      nclusters = end - cluster;
+    }
+
+  for (n = 0; n < nclusters; n++, cluster++)
+    {
+      if ((fs->fs_freemap[cluster >> 5] & FREEMAP_BIT(cluster)) == 0)
+        {
+          break;
+        }
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: fat_allocrun
+ *
+ * Description:
+ *   Add a run of 'nclusters' contiguous free clusters to the chain that
+ *   ends with 'cluster', or create a new chain if 'cluster' is zero.
+ *
+ * Returned Value:
+ *   <0:error, 0: there is no such run, >=2: the first cluster of the run
+ *
+ ****************************************************************************/
+
+static int32_t fat_allocrun(FAR struct fat_mountpt_s *fs, uint32_t cluster,
+                            uint32_t nclusters)
+{
+  uint32_t first = 0;
+  uint32_t start;
+  uint32_t end;
+  uint32_t hint;
+  uint32_t len;
+  uint32_t i;
+  int      ret;
+
+  hint = cluster != 0 ? cluster : fs->fs_fsinextfree;
+
+  fat_freemapinit(fs);
+  if (fs->fs_freemap == NULL ||
+      (fs->fs_fsifreecount <= fs->fs_nclusters &&
+       fs->fs_fsifreecount < nclusters))
+    {
+      return 0;
+    }
 
-      return -EINVAL;
+  if (hint < 1 || hint >= fs->fs_nclusters + 2)
+    {
+      hint = 1;
     }
 
-  /* Get the sectors per cluster */
+  /* Find the first run that is long enough after the hint, then wrap
+   * around to the beginning of the FAT.
+   */
 
-  fs->fs_fatsecperclus = FBR_GETSECPERCLUS(fs->fs_buffer);
-  if (fs->fs_fatsecperclus == 0)
+  start = hint + 1;
+  end   = fs->fs_nclusters + 2;
+  for (; ; )
     {
-      fwarn("WARNING: sectors per cluster cannot be 0\n");
-      return -EINVAL;
-    }
+      start = fat_freemapfind(fs, start, end);
+      if (start == 0)
+        {
+          if (end <= hint + 1)
+            {
+              return 0;
+            }
 
-  /* Calculate the number of clusters */
+          start = 2;
+          end   = hint + 1;
+          continue;
+        }
 
-  fs->fs_nclusters = ndatasectors / fs->fs_fatsecperclus;
+      len = fat_freemaprun(fs, start, nclusters);
+      if (len == nclusters)
+        {
+          first = start;
+          break;
+        }
 
-  /* Finally, the test: */
+      start += len;
+    }
 
-  if (fs->fs_nclusters <= FAT_MAXCLUST12)
+  /* Chain the run together, terminate it and then link it to the chain */
+
+  for (i = 0; i < nclusters; i++)
     {
-      fs->fs_fsinfo = 0;
-      fs->fs_type   = FSTYPE_FAT12;
+      ret = fat_putcluster(fs, first + i,
+                           i + 1 < nclusters ? first + i + 1 : 0x0fffffff);
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
-  else if (fs->fs_nclusters <= FAT_MAXCLUST16)
+
+  if (cluster != 0)
     {
-      fs->fs_fsinfo = 0;
-      fs->fs_type   = FSTYPE_FAT16;
+      ret = fat_putcluster(fs, cluster, first);
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
-  else if (!notfat32)
+
+  fs->fs_fsinextfree = first + nclusters - 1;
+  if (fs->fs_fsifreecount != 0xffffffff)
     {
-      fs->fs_fsinfo = fs->fs_fatbase + FBR_GETFSINFO(fs->fs_buffer);
-      fs->fs_type   = FSTYPE_FAT32;
+      fs->fs_fsifreecount -= nclusters;
+      fs->fs_fsidirty = true;
     }
-  else
-    {
-      fwarn("WARNING: notfat32: %d fs_nclusters: %" PRId32 "\n",
-            notfat32, fs->fs_nclusters);
 
-      return -EINVAL;
-    }
+  return first;
+}
+#endif /* CONFIG_FAT_FREEMAP */
 
-  /* We have what appears to be a valid FAT filesystem! Save a few more
-   * things from the boot record that we will need later.
-   */
+/****************************************************************************
+ * Name: fat_findfree
+ *
+ * Description:
+ *   Find a free cluster after 'startcluster', wrapping around to the
+ *   beginning of the FAT.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: the free cluster
+ *
+ ****************************************************************************/
 
-  fs->fs_fatbase     += fs->fs_fatresvdseccount;
+static off_t fat_findfree(FAR struct fat_mountpt_s *fs,
+                          uint32_t startcluster)
+{
+  uint32_t newcluster;
+  off_t    startsector;
 
-  if (fs->fs_type == FSTYPE_FAT32)
+#ifdef CONFIG_FAT_FREEMAP
+  fat_freemapinit(fs);
+  if (fs->fs_freemap != NULL)
     {
-      fs->fs_rootbase = FBR_GETROOTCLUS(fs->fs_buffer);
+      newcluster = fat_freemapfind(fs, startcluster + 1,
+                                   fs->fs_nclusters + 2);
+      if (newcluster == 0)
+        {
+          newcluster = fat_freemapfind(fs, 2, startcluster + 1);
+        }
+
+      return newcluster;
     }
-  else
+#endif
+
+  /* Loop until (1) we discover that there are not free clusters
+   * (return 0), an errors occurs (return -errno), or (3) we find
+   * the next cluster (return the new cluster number).
+   */
+
+  newcluster = startcluster;
+  for (; ; )
     {
-      fs->fs_rootbase = fs->fs_fatbase + ntotalfatsects;
-    }
+      /* Examine the next cluster in the FAT */
 
-  fs->fs_database     = fs->fs_fatbase + ntotalfatsects + fs->fs_rootentcnt /
-                        DIRSEC_NDIRS(fs);
-  fs->fs_fsifreecount = 0xffffffff;
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters + 2)
+        {
+          /* If we hit the end of the available clusters, then
+           * wrap back to the beginning because we might have
+           * started at a non-optimal place.  But don't continue
+           * past the start cluster.
+           */
 
-  return OK;
+          newcluster = 2;
+          if (newcluster > startcluster)
+            {
+              /* We are back past the starting cluster, then there
+               * is no free cluster.
+               */
+
+              return 0;
+            }
+        }
+
+      /* We have a candidate cluster.  Check if the cluster number is
+       * mapped to a group of sectors.
+       */
+
+      startsector = fat_getcluster(fs, newcluster);
+      if (startsector == 0)
+        {
+          /* Found have found a free cluster break out */
+
+          return newcluster;
+        }
+      else if (startsector < 0)
+        {
+          /* Some error occurred, return the error number */
+
+          return startsector;
+        }
+
+      /* We wrap all the back to the starting cluster?  If so, then
+       * there are no free clusters.
+       */
+
+      if (newcluster == startcluster)
+        {
+          return 0;
+        }
+    }
 }
 
 /****************************************************************************
@@ -520,6 +1290,14 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+  /* Allocate the sector cache, if any */
+
+  ret = fat_fscacheinit(fs);
+  if (ret < 0)
+    {
+      goto errout_with_buffer;
+    }
+
   /* Search FAT boot record on the drive.  First check the MBR at sector
    * zero.  This could be either the boot record or a partition that refers
    * to the boot record.
@@ -658,6 +1436,10 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#ifdef CONFIG_FAT_FREEMAP
+  fat_freemapuninit(fs);
+#endif
+  fat_fscacheuninit(fs);
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = NULL;
 
@@ -722,26 +1504,19 @@ int fat_checkmount(struct fat_mountpt_s *fs)
 int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
                unsigned int nsectors)
 {
-  int ret = -ENODEV;
-  if (fs && fs->fs_blkdriver)
+#if CONFIG_FAT_FSCACHE_SECTORS > 0
+  int ret;
+
+  /* Write back any newer copy of the sectors in the sector cache */
+
+  ret = fat_fscachesync(fs, sector, nsectors);
+  if (ret < 0)
     {
-      struct inode *inode = fs->fs_blkdriver;
-      if (inode && inode->u.i_bops && inode->u.i_bops->read)
-        {
-          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
-                                                       sector, nsectors);
-          if (nsectorsread == nsectors)
-            {
-              ret = OK;
-            }
-          else if (nsectorsread < 0)
-            {
-              ret = nsectorsread;
-            }
-        }
+      return ret;
     }
+#endif
 
-  return ret;
+  return fat_blkread(fs, buffer, sector, nsectors);
 }
 
 /****************************************************************************
@@ -755,27 +1530,13 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
 int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
                 unsigned int nsectors)
 {
-  int ret = -ENODEV;
-  if (fs && fs->fs_blkdriver)
-    {
-      struct inode *inode = fs->fs_blkdriver;
-      if (inode && inode->u.i_bops && inode->u.i_bops->write)
-        {
-          ssize_t nsectorswritten =
-              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+#if CONFIG_FAT_FSCACHE_SECTORS > 0
+  /* The sector cache must not hold older copies of the sectors */
 
-          if (nsectorswritten == nsectors)
-            {
-              ret = OK;
-            }
-          else if (nsectorswritten < 0)
-            {
-              ret = nsectorswritten;
-            }
-        }
-    }
+  fat_fscacheinval(fs, sector, nsectors);
+#endif
 
-  return ret;
+  return fat_blkwrite(fs, buffer, sector, nsectors);
 }
 
 /****************************************************************************
@@ -1103,6 +1864,21 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+
+#ifdef CONFIG_FAT_FREEMAP
+      if (fs->fs_freemap != NULL && clusterno >= 2)
+        {
+          if (nextcluster == 0)
+            {
+              fs->fs_freemap[clusterno >> 5] |= FREEMAP_BIT(clusterno);
+            }
+          else
+            {
+              fs->fs_freemap[clusterno >> 5] &= ~FREEMAP_BIT(clusterno);
+            }
+        }
+#endif
+
       return OK;
     }
 
@@ -1201,92 +1977,44 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
        * is a valid cluster by examining its start sector.
        */
 
-      startsector = fat_getcluster(fs, cluster);
-      if (startsector < 0)
-        {
-          /* An error occurred, return the error value */
-
-          return startsector;
-        }
-      else if (startsector < 2)
-        {
-          /* Oops.. this cluster does not exist. */
-
-          return 0;
-        }
-      else if (startsector < fs->fs_nclusters + 2)
-        {
-          /* It is already followed by next cluster */
-
-          return startsector;
-        }
-
-      /* Okay.. it checks out */
-
-      startcluster = cluster;
-    }
-
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
-   */
-
-  newcluster = startcluster;
-  for (; ; )
-    {
-      /* Examine the next cluster in the FAT */
-
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters + 2)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
-
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
+      startsector = fat_getcluster(fs, cluster);
+      if (startsector < 0)
         {
-          /* Found have found a free cluster break out */
+          /* An error occurred, return the error value */
 
-          break;
+          return startsector;
         }
-      else if (startsector < 0)
+      else if (startsector < 2)
         {
-          /* Some error occurred, return the error number */
+          /* Oops.. this cluster does not exist. */
+
+          return 0;
+        }
+      else if (startsector < fs->fs_nclusters + 2)
+        {
+          /* It is already followed by next cluster */
 
           return startsector;
         }
 
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
+      /* Okay.. it checks out */
 
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      startcluster = cluster;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
-   */
+  /* Find a free cluster, preferably the one following the start cluster */
+
+  startsector = fat_findfree(fs, startcluster);
+  if (startsector <= 0)
+    {
+      /* An error occurred or there is no free cluster */
+
+      return startsector;
+    }
+
+  newcluster = startsector;
+
+  /* Now mark that cluster as in-use */
 
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
   if (ret < 0)
@@ -1323,6 +2051,84 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+/****************************************************************************
+ * Name: fat_extendrun
+ *
+ * Description:
+ *   Add 'nclusters' new clusters to the chain following cluster (if cluster
+ *   is non-zero), or create a new chain of 'nclusters' clusters (if cluster
+ *   is zero).  The clusters are taken from one contiguous run of free
+ *   clusters if possible; otherwise they are allocated one at a time.  As
+ *   with fat_extendchain(), nothing is allocated if cluster is already
+ *   followed by another cluster.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: first new cluster number
+ *
+ ****************************************************************************/
+
+int32_t fat_extendrun(struct fat_mountpt_s *fs, uint32_t cluster,
+                      uint32_t nclusters)
+{
+  int32_t newcluster;
+  int32_t first;
+  off_t   next;
+
+  if (cluster != 0)
+    {
+      /* Check that this is the end of an existing chain */
+
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          return next;
+        }
+      else if (next < 2)
+        {
+          /* Oops.. this cluster does not exist. */
+
+          return 0;
+        }
+      else if (next < fs->fs_nclusters + 2)
+        {
+          /* It is already followed by next cluster */
+
+          return next;
+        }
+    }
+
+#ifdef CONFIG_FAT_FREEMAP
+  if (nclusters > 1)
+    {
+      first = fat_allocrun(fs, cluster, nclusters);
+      if (first != 0)
+        {
+          return first;
+        }
+    }
+#endif
+
+  first = fat_extendchain(fs, cluster);
+  if (first < 2 || first >= fs->fs_nclusters + 2)
+    {
+      return first;
+    }
+
+  newcluster = first;
+  while (--nclusters > 0)
+    {
+      newcluster = fat_extendchain(fs, newcluster);
+      if (newcluster < 2 || newcluster >= fs->fs_nclusters + 2)
+        {
+          /* The remaining clusters are left to later extensions */
+
+          break;
+        }
+    }
+
+  return newcluster < 0 ? newcluster : first;
+}
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
@@ -1597,6 +2403,7 @@ int fat_dirshrink(struct fat_mountpt_s *fs, FAR uint8_t *direntry,
 int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
                   off_t length)
 {
+  off_t clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
   int32_t cluster;
   off_t remaining;
   off_t pos;
@@ -1619,9 +2426,12 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
 
       if (ff->ff_startcluster == 0)
         {
-          /* No.. we have to create a new cluster chain */
+          /* No.. we have to create a new cluster chain.  Allocate all of
+           * its clusters at once so that they can be contiguous.
+           */
 
-          ff->ff_startcluster     = fat_createchain(fs);
+          ff->ff_startcluster     =
+            fat_extendrun(fs, 0, (length + clustersize - 1) / clustersize);
           ff->ff_currentcluster   = ff->ff_startcluster;
           ff->ff_sectorsincluster = fs->fs_fatsecperclus;
         }
@@ -1653,11 +2463,14 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
 
       if (ff->ff_sectorsincluster < 1)
         {
-          /* Extend the current cluster by one (unless lseek was used to
-           * move the file position back from the end of the file)
+          /* Extend the current cluster (unless lseek was used to move the
+           * file position back from the end of the file) by all clusters
+           * still needed.
            */
 
-          cluster = fat_extendchain(fs, ff->ff_currentcluster);
+          cluster = fat_extendrun(fs, ff->ff_currentcluster,
+                                  (remaining + clustersize - 1) /
+                                  clustersize);
 
           /* Verify the cluster number */
 
@@ -1758,16 +2571,103 @@ int fat_dirextend(FAR struct fat_mountpt_s *fs, FAR struct fat_file_s *ff,
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_fscacheinit
+ *
+ * Description:
+ *   Allocate the sector cache of a mountpoint.  fs_hwsectorsize must be
+ *   known.
+ *
+ ****************************************************************************/
+
+int fat_fscacheinit(struct fat_mountpt_s *fs)
+{
+#if CONFIG_FAT_FSCACHE_SECTORS > 0
+  int i;
+
+  /* Nothing is buffered in fs_buffer yet */
+
+  fs->fs_currentsector = -1;
+
+  for (i = 0; i < CONFIG_FAT_FSCACHE_SECTORS; i++)
+    {
+      fs->fs_cache[i].fc_sector = -1;
+      fs->fs_cache[i].fc_dirty  = false;
+      fs->fs_cache[i].fc_buffer = fat_io_alloc(fs->fs_hwsectorsize);
+      if (fs->fs_cache[i].fc_buffer == NULL)
+        {
+          goto errout;
+        }
+    }
+
+#if CONFIG_FAT_FSCACHE_READAHEAD > 0
+  fs->fs_rabuffer = fat_io_alloc((CONFIG_FAT_FSCACHE_READAHEAD + 1) *
+                                 fs->fs_hwsectorsize);
+  if (fs->fs_rabuffer == NULL)
+    {
+      goto errout;
+    }
+#endif
+
+  return OK;
+
+errout:
+  fat_fscacheuninit(fs);
+  return -ENOMEM;
+#else
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: fat_fscacheuninit
+ *
+ * Description:
+ *   Free the sector cache of a mountpoint, discarding its contents.
+ *
+ ****************************************************************************/
+
+void fat_fscacheuninit(struct fat_mountpt_s *fs)
+{
+#if CONFIG_FAT_FSCACHE_SECTORS > 0
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_FSCACHE_SECTORS; i++)
+    {
+      if (fs->fs_cache[i].fc_buffer != NULL)
+        {
+          fat_io_free(fs->fs_cache[i].fc_buffer, fs->fs_hwsectorsize);
+          fs->fs_cache[i].fc_buffer = NULL;
+        }
+
+      fs->fs_cache[i].fc_sector = -1;
+    }
+
+#if CONFIG_FAT_FSCACHE_READAHEAD > 0
+  if (fs->fs_rabuffer != NULL)
+    {
+      fat_io_free(fs->fs_rabuffer, (CONFIG_FAT_FSCACHE_READAHEAD + 1) *
+                                   fs->fs_hwsectorsize);
+      fs->fs_rabuffer = NULL;
+    }
+#endif
+#endif
+}
+
 /****************************************************************************
  * Name: fat_fscacheflush
  *
  * Description:
- *   Flush any dirty sector if fs_buffer as necessary
+ *   Flush any dirty sector if fs_buffer and the sector cache as necessary
  *
  ****************************************************************************/
 
 int fat_fscacheflush(struct fat_mountpt_s *fs)
 {
+#if CONFIG_FAT_FSCACHE_SECTORS > 0
+  FAR struct fat_cache_s *entry;
+  int i;
+#endif
   int ret;
 
   /* Check if the fs_buffer is dirty.  In this case, we will write back the
@@ -1778,36 +2678,38 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
     {
       /* Write the dirty sector */
 
-      ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
+      ret = fat_fscachewrite(fs, fs->fs_buffer, fs->fs_currentsector);
       if (ret < 0)
         {
           return ret;
         }
 
-      /* Does the sector lie in the FAT region? */
+      /* No longer dirty */
 
-      if (fs->fs_currentsector >= fs->fs_fatbase &&
-          fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
-        {
-          int i;
+      fs->fs_dirty = false;
+    }
 
-          /* Yes, then make the change in the FAT copy as well */
+#if CONFIG_FAT_FSCACHE_SECTORS > 0
+  /* Then write back the dirty sectors of the cache.  Outdated copies of
+   * the sector in fs_buffer must go now, as fs_currentsector may be
+   * assigned again before the next fat_fscacheread().
+   */
 
-          for (i = fs->fs_fatnumfats; i >= 2; i--)
+  for (i = 0; i < CONFIG_FAT_FSCACHE_SECTORS; i++)
+    {
+      entry = &fs->fs_cache[i];
+      if (!fat_fscachestale(fs, entry) && entry->fc_dirty)
+        {
+          ret = fat_fscachewrite(fs, entry->fc_buffer, entry->fc_sector);
+          if (ret < 0)
             {
-              fs->fs_currentsector += fs->fs_nfatsects;
-              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
-              if (ret < 0)
-                {
-                  return ret;
-                }
+              return ret;
             }
-        }
-
-      /* No longer dirty */
 
-      fs->fs_dirty = false;
+          entry->fc_dirty = false;
+        }
     }
+#endif
 
   return OK;
 }
@@ -1819,10 +2721,21 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
  *   Read the specified sector into the sector cache, flushing any existing
  *   dirty sectors as necessary.
  *
+ *   With CONFIG_FAT_FSCACHE_SECTORS, the sector previously held in
+ *   fs_buffer is kept in an LRU cache, dirty or not, and a cached sector is
+ *   copied into fs_buffer instead of being read again.  fs_buffer itself
+ *   never moves, so pointers into it stay valid.
+ *
  ****************************************************************************/
 
 int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 {
+#if CONFIG_FAT_FSCACHE_SECTORS > 0
+  FAR struct fat_cache_s *entry = NULL;
+  FAR struct fat_cache_s *victim;
+  bool dirty;
+  int i;
+#endif
   int ret;
 
   /* fs->fs_currentsector holds the current sector that is buffered in
@@ -1832,6 +2745,62 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 
   if (fs->fs_currentsector != sector)
     {
+#if CONFIG_FAT_FSCACHE_SECTORS > 0
+      /* Look for the sector in the cache */
+
+      for (i = 0; i < CONFIG_FAT_FSCACHE_SECTORS; i++)
+        {
+          if (!fat_fscachestale(fs, &fs->fs_cache[i]) &&
+              fs->fs_cache[i].fc_sector == sector)
+            {
+              entry = &fs->fs_cache[i];
+            }
+        }
+
+      if (entry != NULL)
+        {
+          /* Exchange the cached sector and the one in fs_buffer */
+
+          fat_fscacheswap(entry->fc_buffer, fs->fs_buffer,
+                          fs->fs_hwsectorsize);
+
+          dirty                = entry->fc_dirty;
+          entry->fc_sector     = fs->fs_currentsector;
+          entry->fc_dirty      = fs->fs_dirty;
+          entry->fc_lru        = ++fs->fs_cachelru;
+          fs->fs_currentsector = sector;
+          fs->fs_dirty         = dirty;
+          return OK;
+        }
+
+      /* Not cached.  Keep the sector in fs_buffer in the cache, then read
+       * the new one.
+       */
+
+      ret = fat_fscacheevict(fs, &victim);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      memcpy(victim->fc_buffer, fs->fs_buffer, fs->fs_hwsectorsize);
+      victim->fc_sector = fs->fs_currentsector;
+      victim->fc_dirty  = fs->fs_dirty;
+      victim->fc_lru    = ++fs->fs_cachelru;
+
+      ret = fat_fscachefill(fs, sector);
+      if (ret < 0)
+        {
+          /* Leave fs_buffer as it was */
+
+          memcpy(fs->fs_buffer, victim->fc_buffer, fs->fs_hwsectorsize);
+          victim->fc_sector = -1;
+          victim->fc_dirty  = false;
+          return ret;
+        }
+
+      fs->fs_dirty = false;
+#else
       /* We will need to read the new sector.  First, flush the cached
        * sector if it is dirty.
        */
@@ -1849,6 +2818,7 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
         {
           return ret;
         }
+#endif
 
       /* Update the cached sector number */
 
@@ -2035,83 +3005,31 @@ int fat_updatefsinfo(struct fat_mountpt_s *fs)
 
 int fat_computefreeclusters(struct fat_mountpt_s *fs)
 {
-  /* We have to count the number of free clusters */
-
   uint32_t nfreeclusters = 0;
-  if (fs->fs_type == FSTYPE_FAT12)
-    {
-      off_t sector;
+  int ret;
+#ifdef CONFIG_FAT_FREEMAP
+  unsigned int i;
 
-      /* Examine every cluster in the fat */
+  /* The free cluster map is kept up to date, so just count it.  If there
+   * is no map yet, try to build it now while the whole FAT has to be read
+   * anyway.
+   */
 
-      for (sector = 2; sector < fs->fs_nclusters + 2; sector++)
+  fat_freemapinit(fs);
+  if (fs->fs_freemap != NULL)
+    {
+      for (i = 0; i < FREEMAP_NWORDS(fs); i++)
         {
-          /* If the cluster is unassigned, then increment the count of free
-           * clusters
-           */
-
-          if ((uint16_t)fat_getcluster(fs, sector) == 0)
-            {
-              nfreeclusters++;
-            }
+          nfreeclusters += popcount(fs->fs_freemap[i]);
         }
     }
   else
+#endif
     {
-      unsigned int cluster;
-      off_t        fatsector;
-      unsigned int offset;
-      int          ret;
-
-      fatsector    = fs->fs_fatbase;
-      offset       = fs->fs_hwsectorsize;
-
-      /* Examine each cluster in the fat */
-
-      for (cluster = fs->fs_nclusters; cluster > 0; cluster--)
+      ret = fat_scanfreeclusters(fs, NULL, &nfreeclusters);
+      if (ret < 0)
         {
-          /* If we are starting a new sector, then read the new sector in
-           * fs_buffer
-           */
-
-          if (offset >= fs->fs_hwsectorsize)
-            {
-              ret = fat_fscacheread(fs, fatsector);
-              if (ret < 0)
-                {
-                  return ret;
-                }
-
-              /* Reset the offset to the next FAT entry.
-               * Increment the sector number to read next time around.
-               */
-
-              offset = 0;
-              fatsector++;
-            }
-
-          /* FAT16 and FAT32 differ only on the size of each cluster start
-           * sector number in the FAT.
-           */
-
-          if (fs->fs_type == FSTYPE_FAT16)
-            {
-              if (FAT_GETFAT16(fs->fs_buffer, offset) == 0)
-                {
-                  nfreeclusters++;
-                }
-
-              offset += 2;
-            }
-          else
-            {
-              if (FAT_GETFAT32(fs->fs_buffer, offset) == 0)
-                {
-                  nfreeclusters++;
-                }
-
-              offset += 4;
-            }
+          return ret;
         }
     }
 
@@ -2124,6 +3042,25 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
   return OK;
 }
 
+#ifdef CONFIG_FAT_FREEMAP
+/****************************************************************************
+ * Name: fat_freemapuninit
+ *
+ * Description:
+ *   Release the map of free clusters
+ *
+ ****************************************************************************/
+
+void fat_freemapuninit(struct fat_mountpt_s *fs)
+{
+  if (fs->fs_freemap != NULL)
+    {
+      fs_heap_free(fs->fs_freemap);
+      fs->fs_freemap = NULL;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_nfreeclusters
  *
@@ -0,0 +1,340 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INODE_CACHE_SIZE     CONFIG_FS_INODE_CACHE_SIZE
+#define INODE_CACHE_PATHLEN  CONFIG_FS_INODE_CACHE_PATHLEN
+
+/* Marks an entry without a relative path (relpath == NULL) */
+
+#define INODE_CACHE_NOREL    UINT16_MAX
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached inode_search() result.  The path and the relative path are
+ * kept as offsets into the searched path, so that they can be applied to
+ * the caller's copy of the path.
+ */
+
+struct inode_cache_s
+{
+  uint32_t gen;                      /* Tree generation, 0: unused */
+  uint32_t hash;                     /* Hash of path[] */
+  FAR struct inode *node;            /* Search result, see inode_search_s */
+  FAR struct inode *peer;
+  FAR struct inode *parent;
+  int16_t ret;                       /* OK or -ENOENT */
+  uint16_t pathoff;                  /* Offset of the returned path */
+  uint16_t reloff;                   /* Offset of the returned relpath */
+  char path[INODE_CACHE_PATHLEN];    /* The absolute path searched */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The cache is direct mapped.  An entry is only valid while its generation
+ * matches g_inode_cache_gen, which changes with every modification of the
+ * inode tree.
+ */
+
+static struct inode_cache_s g_inode_cache[INODE_CACHE_SIZE];
+static uint32_t g_inode_cache_gen = 1;
+static spinlock_t g_inode_cache_lock = SP_UNLOCKED;
+
+static uint32_t g_inode_cache_nhit;
+static uint32_t g_inode_cache_nneg;
+static uint32_t g_inode_cache_nmiss;
+static uint32_t g_inode_cache_ninval;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of 'path' and its length.
+ *
+ ****************************************************************************/
+
+static uint32_t inode_cache_hash(FAR const char *path, FAR size_t *len)
+{
+  FAR const char *ptr = path;
+  uint32_t hash = 2166136261u;
+
+  while (*ptr != '\0')
+    {
+      hash = (hash ^ (uint8_t)*ptr++) * 16777619u;
+    }
+
+  *len = ptr - path;
+  return hash;
+}
+
+/****************************************************************************
+ * Name: inode_cache_offset
+ *
+ * Description:
+ *   Return the offset of 'ptr' within the 'len' bytes long string 'path',
+ *   or a negative value if it does not point into that string.
+ *
+ ****************************************************************************/
+
+static int inode_cache_offset(FAR const char *path, size_t len,
+                              FAR const char *ptr)
+{
+  uintptr_t start = (uintptr_t)path;
+
+  if ((uintptr_t)ptr < start || (uintptr_t)ptr > start + len)
+    {
+      return -1;
+    }
+
+  return (uintptr_t)ptr - start;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the result of a previous inode_search() of desc->path.  On a
+ *   hit, the search descriptor is set up as the search would have and the
+ *   result of the search is returned in 'ret'.
+ *
+ * Returned Value:
+ *   true if the path was found in the cache.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode_search_s *desc, FAR int *ret)
+{
+  FAR struct inode_cache_s *entry;
+  FAR const char *path = desc->path;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+  bool found = false;
+
+  hash = inode_cache_hash(path, &len);
+  if (len >= INODE_CACHE_PATHLEN)
+    {
+      return false;
+    }
+
+  entry = &g_inode_cache[hash % INODE_CACHE_SIZE];
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+  if (entry->gen == g_inode_cache_gen && entry->hash == hash &&
+      strcmp(entry->path, path) == 0)
+    {
+      desc->path    = path + entry->pathoff;
+      desc->node    = entry->node;
+      desc->peer    = entry->peer;
+      desc->parent  = entry->parent;
+      desc->relpath = entry->reloff == INODE_CACHE_NOREL ?
+                      NULL : path + entry->reloff;
+      *ret          = entry->ret;
+
+      if (entry->ret < 0)
+        {
+          g_inode_cache_nneg++;
+        }
+
+      g_inode_cache_nhit++;
+      found = true;
+    }
+  else
+    {
+      g_inode_cache_nmiss++;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+  return found;
+}
+
+/****************************************************************************
+ * Name: inode_cache_add
+ *
+ * Description:
+ *   Remember the result 'ret' of an inode_search() of 'path' that left the
+ *   search descriptor 'desc'.  Only successful searches and searches that
+ *   failed with -ENOENT are cached, and only if all of the returned paths
+ *   point into 'path'.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc, int ret)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+  int pathoff;
+  int reloff = INODE_CACHE_NOREL;
+
+  if (ret != OK && ret != -ENOENT)
+    {
+      return;
+    }
+
+  hash = inode_cache_hash(path, &len);
+  if (len >= INODE_CACHE_PATHLEN)
+    {
+      return;
+    }
+
+  pathoff = inode_cache_offset(path, len, desc->path);
+  if (desc->relpath != NULL)
+    {
+      reloff = inode_cache_offset(path, len, desc->relpath);
+    }
+
+  if (pathoff < 0 || reloff < 0)
+    {
+      /* The search went through a soft link */
+
+      return;
+    }
+
+  entry = &g_inode_cache[hash % INODE_CACHE_SIZE];
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+  entry->gen     = g_inode_cache_gen;
+  entry->hash    = hash;
+  entry->node    = desc->node;
+  entry->peer    = desc->peer;
+  entry->parent  = desc->parent;
+  entry->ret     = ret;
+  entry->pathoff = pathoff;
+  entry->reloff  = reloff;
+  memcpy(entry->path, path, len + 1);
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Discard all cached search results.  This must be called whenever the
+ *   inode tree is modified.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock for writing.
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  if (++g_inode_cache_gen == 0)
+    {
+      /* Entries of the generation that is about to be reused must not
+       * become valid again.
+       */
+
+      for (i = 0; i < INODE_CACHE_SIZE; i++)
+        {
+          g_inode_cache[i].gen = 0;
+        }
+
+      g_inode_cache_gen = 1;
+    }
+
+  g_inode_cache_ninval++;
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_getstats
+ *
+ * Description:
+ *   Return the statistics of the path lookup cache.
+ *
+ ****************************************************************************/
+
+void inode_cache_getstats(FAR struct inode_cache_stats_s *stats)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  stats->nentries = INODE_CACHE_SIZE;
+  stats->nvalid   = 0;
+
+  for (i = 0; i < INODE_CACHE_SIZE; i++)
+    {
+      if (g_inode_cache[i].gen == g_inode_cache_gen)
+        {
+          stats->nvalid++;
+        }
+    }
+
+  stats->nhit     = g_inode_cache_nhit;
+  stats->nneg     = g_inode_cache_nneg;
+  stats->nmiss    = g_inode_cache_nmiss;
+  stats->ninval   = g_inode_cache_ninval;
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+#endif /* CONFIG_FS_INODE_CACHE */
@@ -79,6 +79,8 @@ static FAR struct inode *inode_unlink(FAR const char *path)
       inode = desc.node;
       DEBUGASSERT(inode != NULL);
 
+      inode_cache_invalidate();
+
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
@@ -109,6 +109,8 @@ static void inode_insert(FAR struct inode *inode,
                          FAR struct inode *peer,
                          FAR struct inode *parent)
 {
+  inode_cache_invalidate();
+
   /* If peer is non-null, then new node simply goes to the right
    * of that peer node.
    */
@@ -358,6 +358,9 @@ static int _inode_search(FAR struct inode_search_s *desc)
                                     {
                                       fs_heap_free(desc->buffer);
                                       desc->buffer = buffer;
+#ifdef CONFIG_FS_INODE_CACHE
+                                      desc->replaced = true;
+#endif
                                       relpath = buffer;
                                       ret = OK;
                                     }
@@ -491,7 +494,27 @@ int inode_search(FAR struct inode_search_s *desc)
       desc->path = desc->buffer;
     }
 
+#ifdef CONFIG_FS_INODE_CACHE
+  if (!inode_cache_lookup(desc, &ret))
+    {
+      FAR const char *path = desc->path;
+
+      desc->replaced = false;
+      ret = _inode_search(desc);
+
+      /* The path is gone if it was in a buffer released while following
+       * a soft link.  Comparing the buffer addresses is not enough, since
+       * a new buffer may be allocated at the address of the old one.
+       */
+
+      if (!desc->replaced)
+        {
+          inode_cache_add(path, desc, ret);
+        }
+    }
+#else
   ret = _inode_search(desc);
+#endif
 
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
   if (ret >= 0)
@@ -131,8 +131,25 @@ struct inode_search_s
   FAR const char *relpath;   /* Relative path into the mountpoint */
   FAR char *buffer;          /* Path expansion buffer */
   bool nofollow;             /* true: Don't follow terminal soft link */
+#ifdef CONFIG_FS_INODE_CACHE
+  bool replaced;             /* true: buffer replaced while searching */
+#endif
 };
 
+/* Statistics of the path lookup cache, see inode_cache_getstats() */
+
+#ifdef CONFIG_FS_INODE_CACHE
+struct inode_cache_stats_s
+{
+  size_t   nentries;                 /* Number of cache entries */
+  size_t   nvalid;                   /* Number of valid cache entries */
+  uint32_t nhit;                     /* Lookups found in the cache */
+  uint32_t nneg;                     /* Hits of non-existent paths */
+  uint32_t nmiss;                    /* Lookups not found in the cache */
+  uint32_t ninval;                   /* Cache invalidations */
+};
+#endif
+
 /* Callback used by foreach_inode to traverse all inodes in the pseudo-
  * file system.
  */
@@ -237,6 +254,30 @@ void inode_runlock(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cache_lookup, inode_cache_add, inode_cache_invalidate and
+ *       inode_cache_getstats
+ *
+ * Description:
+ *   Cache of inode_search() results, including searches for paths that do
+ *   not exist.  The cache is discarded by inode_cache_invalidate() on any
+ *   modification of the inode tree.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock (for writing when invalidating).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+bool inode_cache_lookup(FAR struct inode_search_s *desc, FAR int *ret);
+void inode_cache_add(FAR const char *path,
+                     FAR const struct inode_search_s *desc, int ret);
+void inode_cache_invalidate(void);
+void inode_cache_getstats(FAR struct inode_cache_stats_s *stats);
+#else
+#  define inode_cache_invalidate()
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
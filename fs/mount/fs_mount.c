@@ -487,6 +487,10 @@ int nx_mount(FAR const char *source, FAR const char *target,
 
   mountpt_inode->u.i_mops  = mops;
   mountpt_inode->i_private = fshandle;
+
+  /* Searches must now stop at the mountpoint */
+
+  inode_cache_invalidate();
   inode_unlock();
 
   /* We can release our reference to the blkdrver_inode, if the filesystem
@@ -134,6 +134,7 @@ int nx_umount2(FAR const char *target, unsigned int flags)
   mountpt_inode->i_flags  &= ~FSNODEFLAG_TYPE_MASK;
   mountpt_inode->i_private = NULL;
   mountpt_inode->u.i_mops  = NULL;
+  inode_cache_invalidate();
 
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   /* If the node has children, then do not delete it. */
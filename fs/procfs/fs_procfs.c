@@ -61,6 +61,7 @@ extern const struct procfs_operations g_cpuinfo_operations;
 extern const struct procfs_operations g_cpuload_operations;
 extern const struct procfs_operations g_critmon_operations;
 extern const struct procfs_operations g_fdt_operations;
+extern const struct procfs_operations g_inodecache_operations;
 extern const struct procfs_operations g_iobinfo_operations;
 extern const struct procfs_operations g_irq_operations;
 extern const struct procfs_operations g_meminfo_operations;
@@ -73,6 +74,7 @@ extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_thermal_operations;
 extern const struct procfs_operations g_uptime_operations;
 extern const struct procfs_operations g_version_operations;
+extern const struct procfs_operations g_wqueue_operations;
 extern const struct procfs_operations g_pressure_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
@@ -129,6 +131,11 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/blocks",    &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_FS_INODE_CACHE) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_INODECACHE)
+  { "fs/inodecache", &g_inodecache_operations, PROCFS_FILE_TYPE },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MOUNT
   { "fs/mount",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
@@ -208,6 +215,12 @@ static const struct procfs_entry_s g_procfs_entries[] =
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_VERSION
   { "version",      &g_version_operations,  PROCFS_FILE_TYPE   },
 #endif
+
+#if defined(CONFIG_SCHED_WORKQUEUE_STATS) && \
+    (defined(CONFIG_SCHED_HPWORK) || defined(CONFIG_SCHED_LPWORK)) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_WQUEUE)
+  { "wqueue",       &g_wqueue_operations,   PROCFS_FILE_TYPE   },
+#endif
 };
 
 #ifdef CONFIG_FS_PROCFS_REGISTER
@@ -0,0 +1,297 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsinodecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_FS_INODE_CACHE) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_INODECACHE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define INODECACHE_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct inodecache_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  unsigned int linesize;          /* Number of valid characters in line[] */
+  char line[INODECACHE_LINELEN];  /* Buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     inodecache_open(FAR struct file *filep,
+                               FAR const char *relpath,
+                               int oflags, mode_t mode);
+static int     inodecache_close(FAR struct file *filep);
+static ssize_t inodecache_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen);
+static int     inodecache_dup(FAR const struct file *oldp,
+                              FAR struct file *newp);
+static int     inodecache_stat(FAR const char *relpath,
+                               FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_inodecache_operations =
+{
+  inodecache_open,   /* open */
+  inodecache_close,  /* close */
+  inodecache_read,   /* read */
+  NULL,              /* write */
+  NULL,              /* poll */
+  inodecache_dup,    /* dup */
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+  inodecache_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inodecache_open
+ ****************************************************************************/
+
+static int inodecache_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode)
+{
+  FAR struct inodecache_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   *
+   * REVISIT:  Write-able proc files could be quite useful.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct inodecache_file_s *)
+    fs_heap_zalloc(sizeof(struct inodecache_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inodecache_close
+ ****************************************************************************/
+
+static int inodecache_close(FAR struct file *filep)
+{
+  FAR struct inodecache_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct inodecache_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inodecache_read
+ ****************************************************************************/
+
+static ssize_t inodecache_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct inodecache_file_s *cachefile;
+  struct inode_cache_stats_s stats;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  cachefile = (FAR struct inodecache_file_s *)filep->f_priv;
+  DEBUGASSERT(cachefile);
+
+  /* The first line is the headers */
+
+  linesize  = procfs_snprintf(cachefile->line, INODECACHE_LINELEN,
+                              "%8s%8s%10s%10s%10s%10s\n",
+                              "size", "valid", "nhit", "nneg",
+                              "nmiss", "ninval");
+
+  copysize  = procfs_memcpy(cachefile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  buffer   += copysize;
+  buflen   -= copysize;
+
+  /* The second line is the cache statistics */
+
+  inode_cache_getstats(&stats);
+  linesize   = procfs_snprintf(cachefile->line, INODECACHE_LINELEN,
+                               "%8zu%8zu%10" PRIu32 "%10" PRIu32
+                               "%10" PRIu32 "%10" PRIu32 "\n",
+                               stats.nentries, stats.nvalid,
+                               stats.nhit, stats.nneg,
+                               stats.nmiss, stats.ninval);
+
+  copysize   = procfs_memcpy(cachefile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: inodecache_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int inodecache_dup(FAR const struct file *oldp,
+                          FAR struct file *newp)
+{
+  FAR struct inodecache_file_s *oldattr;
+  FAR struct inodecache_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct inodecache_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct inodecache_file_s *)
+    fs_heap_malloc(sizeof(struct inodecache_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct inodecache_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: inodecache_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int inodecache_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "fs/inodecache" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_FS_INODE_CACHE && !CONFIG_FS_PROCFS_EXCLUDE_INODECACHE */
@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -183,6 +184,10 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct iobinfo_file_s *iobfile;
   FAR struct iob_stats_s stats;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  struct iob_cachestats_s cstats;
+  int cpu;
+#endif
   size_t linesize;
   size_t copysize;
   size_t totalsize;
@@ -223,6 +228,38 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                              &offset);
   totalsize += copysize;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Then the per-CPU cache statistics, one line per CPU */
+
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10s%10s%10s%10s%10s\n",
+                               "cpu", "ncached", "nhit", "nrefill",
+                               "ndrain");
+
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+
+  for (cpu = 0; iob_getcachestats(cpu, &cstats) >= 0; cpu++)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                                   "%10d%10d%10" PRIu32 "%10" PRIu32
+                                   "%10" PRIu32 "\n",
+                                   cpu, cstats.ncached, cstats.nhit,
+                                   cstats.nrefill, cstats.ndrain);
+
+      copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
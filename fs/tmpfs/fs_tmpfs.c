@@ -58,6 +58,23 @@
 #  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
+#ifndef CONFIG_FS_TMPFS_GROWTH
+#  define CONFIG_FS_TMPFS_GROWTH 0
+#endif
+
+/* The amount allocated beyond the needs of an object growing to 'size'
+ * bytes: the fixed guard plus a proportion of the size.
+ */
+
+#define TMPFS_OVERALLOC(size, guard) \
+           ((guard) + (size) / 100 * CONFIG_FS_TMPFS_GROWTH)
+
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+#  define tmpfs_free_hash(tdo) fs_heap_free((tdo)->tdo_hash)
+#else
+#  define tmpfs_free_hash(tdo)
+#endif
+
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
 #define tmpfs_lock_object(to) \
@@ -96,6 +113,15 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+static uint32_t tmpfs_hash(FAR const char *name, size_t len);
+static FAR uint16_t *tmpfs_hash_link(FAR struct tmpfs_directory_s *tdo,
+                                     unsigned int index);
+static void tmpfs_hash_add(FAR struct tmpfs_directory_s *tdo,
+                           unsigned int index);
+#endif
+static void tmpfs_del_dirent(FAR struct tmpfs_directory_s *tdo,
+                             unsigned int index);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
@@ -247,7 +273,7 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
    * reallocations.
    */
 
-  objsize += CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD;
+  objsize += TMPFS_OVERALLOC(objsize, CONFIG_FS_TMPFS_DIRECTORY_ALLOCGUARD);
 
   /* Realloc the directory object */
 
@@ -297,37 +323,36 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
           tfo->tfo_size = 0;
           return OK;
         }
-      else if (newsize > 0)
-        {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
 
-          delta = tfo->tfo_alloc - newsize;
-
-          /* We should make sure the shrunked memory be zero */
-
-          memset(tfo->tfo_data + newsize, 0, delta);
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
-            {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+      /* Otherwise, don't realloc unless the object has shrunk by a lot,
+       * more than it would be over-allocated when growing to this size.
+       * Growing within the allocation needs no realloc at all.
+       */
 
-              tfo->tfo_size = newsize;
-              return OK;
-            }
+      delta = tfo->tfo_alloc - newsize;
+      if (newsize >= tfo->tfo_size ||
+          delta <= TMPFS_OVERALLOC(newsize, CONFIG_FS_TMPFS_FILE_FREEGUARD))
+        {
+          tfo->tfo_size = newsize;
+          return OK;
         }
-    }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
-
-  allocsize = newsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
-  if (allocsize < newsize)
+      allocsize = newsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+    }
+  else
     {
-      /* There must have been an integer overflow */
+      /* Added some additional amount to the new size to account frequent
+       * reallocations.
+       */
 
-      return -ENOMEM;
+      allocsize = newsize +
+                  TMPFS_OVERALLOC(newsize, CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
+      if (allocsize < newsize)
+        {
+          /* There must have been an integer overflow */
+
+          return -ENOMEM;
+        }
     }
 
   /* Realloc the file object */
@@ -346,6 +371,164 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of a directory entry name.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+static uint32_t tmpfs_hash(FAR const char *name, size_t len)
+{
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0)
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_link
+ *
+ * Description:
+ *   Return the link (bucket head or tde_next of the previous entry) that
+ *   refers to the directory entry at 'index' in its hash chain.
+ *
+ ****************************************************************************/
+
+static FAR uint16_t *tmpfs_hash_link(FAR struct tmpfs_directory_s *tdo,
+                                     unsigned int index)
+{
+  FAR uint16_t *link;
+
+  link = &tdo->tdo_hash[tdo->tdo_entry[index].tde_hash &
+                        (tdo->tdo_nbuckets - 1)];
+  while (*link != index + 1)
+    {
+      DEBUGASSERT(*link != 0);
+      link = &tdo->tdo_entry[*link - 1].tde_next;
+    }
+
+  return link;
+}
+
+/****************************************************************************
+ * Name: tmpfs_hash_add
+ *
+ * Description:
+ *   Add the new directory entry at 'index' to the hash table, growing the
+ *   table so that there are at least as many buckets as entries.  Without
+ *   memory for the table, the chains just get longer or, if there is no
+ *   table at all, tmpfs_find_dirent() searches linearly.
+ *
+ ****************************************************************************/
+
+static void tmpfs_hash_add(FAR struct tmpfs_directory_s *tdo,
+                           unsigned int index)
+{
+  FAR struct tmpfs_dirent_s *tde;
+  FAR uint16_t *hash;
+  unsigned int nbuckets;
+  unsigned int i;
+
+  if (tdo->tdo_nentries > tdo->tdo_nbuckets)
+    {
+      nbuckets = tdo->tdo_nbuckets > 0 ? 2 * tdo->tdo_nbuckets : 8;
+      while (nbuckets < tdo->tdo_nentries)
+        {
+          nbuckets <<= 1;
+        }
+
+      hash = nbuckets <= UINT16_MAX ?
+             fs_heap_zalloc(nbuckets * sizeof(uint16_t)) : NULL;
+      if (hash != NULL)
+        {
+          /* Rehash all entries, including the new one */
+
+          fs_heap_free(tdo->tdo_hash);
+          tdo->tdo_hash     = hash;
+          tdo->tdo_nbuckets = nbuckets;
+
+          for (i = 0; i < tdo->tdo_nentries; i++)
+            {
+              tde           = &tdo->tdo_entry[i];
+              tde->tde_next = hash[tde->tde_hash & (nbuckets - 1)];
+              hash[tde->tde_hash & (nbuckets - 1)] = i + 1;
+            }
+
+          return;
+        }
+    }
+
+  if (tdo->tdo_hash != NULL)
+    {
+      tde           = &tdo->tdo_entry[index];
+      hash          = &tdo->tdo_hash[tde->tde_hash &
+                                     (tdo->tdo_nbuckets - 1)];
+      tde->tde_next = *hash;
+      *hash         = index + 1;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tmpfs_del_dirent
+ *
+ * Description:
+ *   Free the directory entry at 'index' and replace it with the final
+ *   directory entry.
+ *
+ ****************************************************************************/
+
+static void tmpfs_del_dirent(FAR struct tmpfs_directory_s *tdo,
+                             unsigned int index)
+{
+  unsigned int last;
+
+  /* Free the object name */
+
+  if (tdo->tdo_entry[index].tde_name != NULL)
+    {
+      fs_heap_free(tdo->tdo_entry[index].tde_name);
+    }
+
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  if (tdo->tdo_hash != NULL)
+    {
+      /* Unlink the entry from its hash chain */
+
+      *tmpfs_hash_link(tdo, index) = tdo->tdo_entry[index].tde_next;
+    }
+#endif
+
+  /* Remove by replacing this entry with the final directory entry */
+
+  last = tdo->tdo_nentries - 1;
+  if (index != last)
+    {
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+      /* Make the hash chain of the final entry refer to its new place */
+
+      if (tdo->tdo_hash != NULL)
+        {
+          *tmpfs_hash_link(tdo, last) = index + 1;
+        }
+#endif
+
+      tdo->tdo_entry[index] = tdo->tdo_entry[last];
+    }
+
+  /* And decrement the count of directory entries */
+
+  tdo->tdo_nentries = last;
+}
+
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
  ****************************************************************************/
@@ -441,6 +624,30 @@ static int tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
         }
     }
 
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  if (tdo->tdo_hash != NULL)
+    {
+      uint32_t hash = tmpfs_hash(name, len);
+
+      /* Search the hash chain for a match */
+
+      for (i = tdo->tdo_hash[hash & (tdo->tdo_nbuckets - 1)];
+           i != 0; i = tdo->tdo_entry[i - 1].tde_next)
+        {
+          FAR struct tmpfs_dirent_s *tde = &tdo->tdo_entry[i - 1];
+
+          if (tde->tde_hash == hash &&
+              strncmp(tde->tde_name, name, len) == 0 &&
+              tde->tde_name[len] == '\0')
+            {
+              return i - 1;
+            }
+        }
+
+      return -ENOENT;
+    }
+#endif
+
   /* Search the list of directory entries for a match */
 
   for (i = 0;
@@ -462,7 +669,6 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
                                FAR const char *name)
 {
   int index;
-  int last;
 
   /* Search the list of directory entries for a match */
 
@@ -472,24 +678,7 @@ static int tmpfs_remove_dirent(FAR struct tmpfs_directory_s *tdo,
       return index;
     }
 
-  /* Free the object name */
-
-  if (tdo->tdo_entry[index].tde_name != NULL)
-    {
-      fs_heap_free(tdo->tdo_entry[index].tde_name);
-    }
-
-  /* Remove by replacing this entry with the final directory entry */
-
-  last = tdo->tdo_nentries - 1;
-  if (index != last)
-    {
-      tdo->tdo_entry[index] = tdo->tdo_entry[last];
-    }
-
-  /* And decrement the count of directory entries */
-
-  tdo->tdo_nentries = last;
+  tmpfs_del_dirent(tdo, index);
   return OK;
 }
 
@@ -552,6 +741,11 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s *tdo,
   tde->tde_object = to;
   tde->tde_name   = newname;
 
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  tde->tde_hash   = tmpfs_hash(newname, namelen);
+  tmpfs_hash_add(tdo, index);
+#endif
+
   return OK;
 }
 
@@ -732,6 +926,10 @@ tmpfs_alloc_directory(FAR struct tmpfs_directory_s *parent)
   tdo->tdo_parent   = parent;
   tdo->tdo_nentries = 0;
   tdo->tdo_entry    = NULL;
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  tdo->tdo_nbuckets = 0;
+  tdo->tdo_hash     = NULL;
+#endif
 
   nxrmutex_init(&tdo->tdo_lock);
 
@@ -1220,34 +1418,13 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
                               unsigned int index, FAR void *arg)
 {
-  FAR struct tmpfs_dirent_s *tde;
   FAR struct tmpfs_object_s *to;
   FAR struct tmpfs_file_s *tfo;
-  unsigned int last;
-
-  /* Free the object name */
 
-  if (tdo->tdo_entry[index].tde_name != NULL)
-    {
-      fs_heap_free(tdo->tdo_entry[index].tde_name);
-    }
-
-  /* Remove by replacing this entry with the final directory entry */
-
-  tde  = &tdo->tdo_entry[index];
-  to   = tde->tde_object;
-  last = tdo->tdo_nentries - 1;
-
-  if (index != last)
-    {
-      /* Move the directory entry */
+  /* Remove the directory entry */
 
-      *tde = tdo->tdo_entry[last];
-    }
-
-  /* And decrement the count of directory entries */
-
-  tdo->tdo_nentries = last;
+  to = tdo->tdo_entry[index].tde_object;
+  tmpfs_del_dirent(tdo, index);
 
   /* Is this directory entry a file object? */
 
@@ -1272,6 +1449,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
       tdo = (FAR struct tmpfs_directory_s *)to;
 
       fs_heap_free(tdo->tdo_entry);
+      tmpfs_free_hash(tdo);
     }
 
   /* Free the object now */
@@ -1611,6 +1789,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct tmpfs_file_s *tfo;
   ssize_t nwritten;
+  size_t oldsize;
   off_t startpos;
   off_t endpos;
   int ret;
@@ -1649,11 +1828,21 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
     {
       /* Reallocate the file to handle the write past the end of the file. */
 
+      oldsize = tfo->tfo_size;
       ret = tmpfs_realloc_file(tfo, (size_t)endpos);
       if (ret < 0)
         {
           goto errout_with_lock;
         }
+
+      /* The memory beyond the old end of the file is not initialized, so
+       * zero the gap if the write starts past the end of the file.
+       */
+
+      if (startpos > oldsize)
+        {
+          memset(&tfo->tfo_data[oldsize], 0, startpos - oldsize);
+        }
     }
 
   /* Copy data from the memory object to the user buffer */
@@ -2260,6 +2449,7 @@ static int tmpfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   nxrmutex_destroy(&tdo->tdo_lock);
   fs_heap_free(tdo->tdo_entry);
+  tmpfs_free_hash(tdo);
   fs_heap_free(tdo);
 
   nxrmutex_destroy(&fs->tfs_lock);
@@ -2569,6 +2759,7 @@ static int tmpfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   nxrmutex_destroy(&tdo->tdo_lock);
   fs_heap_free(tdo->tdo_entry);
+  tmpfs_free_hash(tdo);
   fs_heap_free(tdo);
 
   /* Release the reference and lock on the parent directory */
@@ -70,6 +70,10 @@ struct tmpfs_dirent_s
 {
   FAR struct tmpfs_object_s *tde_object;
   FAR char *tde_name;
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  uint32_t tde_hash;     /* Hash of tde_name */
+  uint16_t tde_next;     /* Next entry in the hash chain + 1, 0 = none */
+#endif
 };
 
 /* The generic form of a TMPFS memory object */
@@ -101,6 +105,13 @@ struct tmpfs_directory_s
 
   uint16_t tdo_nentries; /* Number of directory entries */
   FAR struct tmpfs_dirent_s *tdo_entry;
+#ifdef CONFIG_FS_TMPFS_DIRECTORY_HASH
+  uint16_t tdo_nbuckets; /* Number of hash buckets, a power of two */
+
+  /* First entry + 1 of each hash chain */
+
+  FAR uint16_t *tdo_hash;
+#endif
 };
 
 #define SIZEOF_TMPFS_DIRECTORY(n) ((n) * sizeof(struct tmpfs_dirent_s))
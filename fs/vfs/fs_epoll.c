@@ -42,6 +42,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
@@ -53,8 +54,11 @@
 struct epoll_node_s
 {
   struct list_node         node;
+  struct list_node         rdnode;   /* The node in the ready list */
   epoll_data_t             data;
-  bool                     notified;
+  bool                     notified; /* Queued in the ready list, or torn
+                                      * down after being reported.
+                                      */
   struct pollfd            pfd;
   FAR struct epoll_head_s *eph;
 };
@@ -67,6 +71,13 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
+  spinlock_t            rdlock;   /* Protect the ready list and notified
+                                   * flags against the poll callbacks.
+                                   */
+  struct list_node      ready;    /* The ready list, store all the setuped
+                                   * epoll node notified by its driver, so
+                                   * that epoll_wait only visits these.
+                                   */
   struct list_node      setup;    /* The setup list, store all the setuped
                                    * epoll node.
                                    */
@@ -242,6 +253,8 @@ static int epoll_do_create(int size, int flags)
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
+  spin_lock_init(&eph->rdlock);
+  list_initialize(&eph->ready);
   list_initialize(&eph->setup);
   list_initialize(&eph->teardown);
   list_initialize(&eph->oneshot);
@@ -322,8 +335,11 @@ static int epoll_setup(FAR epoll_head_t *eph)
  * Name: epoll_teardown
  *
  * Description:
- *   Teardown all the notifed fd and check the notified fd's event with user
- *   expected event.
+ *   Take the notified fd from the ready list and check the notified fd's
+ *   event with user expected event.  The level triggered fd are torn down
+ *   to be setup again by the next epoll_setup(), the edge triggered fd stay
+ *   setup and are only reported again on the next notification.  The fd
+ *   that do not fit in evs stay in the ready list.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -339,49 +355,105 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  flags = spin_lock_irqsave(&eph->rdlock);
+  while (i < maxevents && !list_is_empty(&eph->ready))
     {
-      /* Only check the notifed fd */
+      epn = container_of(list_remove_head(&eph->ready), epoll_node_t,
+                         rdnode);
 
-      if (!epn->notified)
+      if ((epn->pfd.events & EPOLLET) != 0)
         {
-          continue;
+          /* Consume the events, the next notification queues it again */
+
+          revents          = epn->pfd.revents;
+          epn->pfd.revents = 0;
+          epn->notified    = false;
+          spin_unlock_irqrestore(&eph->rdlock, flags);
+
+          if (revents != 0)
+            {
+              evs[i].data     = epn->data;
+              evs[i++].events = revents;
+              if ((epn->pfd.events & EPOLLONESHOT) != 0)
+                {
+                  poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+                  list_delete(&epn->node);
+                  list_add_tail(&eph->oneshot, &epn->node);
+                }
+            }
         }
+      else
+        {
+          spin_unlock_irqrestore(&eph->rdlock, flags);
 
-      /* Teradown all the notified fd */
+          /* Teradown the notified fd */
 
-      poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-      list_delete(&epn->node);
+          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+          list_delete(&epn->node);
 
-      if (epn->pfd.revents != 0 && i < maxevents)
-        {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
+          if (epn->pfd.revents != 0)
             {
-              list_add_tail(&eph->oneshot, &epn->node);
+              evs[i].data     = epn->data;
+              evs[i++].events = epn->pfd.revents;
+              if ((epn->pfd.events & EPOLLONESHOT) != 0)
+                {
+                  list_add_tail(&eph->oneshot, &epn->node);
+                }
+              else
+                {
+                  list_add_tail(&eph->teardown, &epn->node);
+                }
             }
           else
             {
               list_add_tail(&eph->teardown, &epn->node);
             }
         }
-      else
-        {
-          list_add_tail(&eph->teardown, &epn->node);
-        }
+
+      flags = spin_lock_irqsave(&eph->rdlock);
     }
 
+  spin_unlock_irqrestore(&eph->rdlock, flags);
   nxmutex_unlock(&eph->lock);
   return i;
 }
 
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove a setuped epoll node from the ready list after it was torn down.
+ *
+ * Input Parameters:
+ *   eph - The epoll head pointer
+ *   epn - The epoll node
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->rdlock);
+  if (epn->notified)
+    {
+      list_delete(&epn->rdnode);
+      epn->notified = false;
+    }
+
+  spin_unlock_irqrestore(&eph->rdlock, flags);
+}
+
 /****************************************************************************
  * Name: epoll_default_cb
  *
@@ -400,9 +472,19 @@ static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
   int semcount = 0;
 
-  epn->notified = true;
+  flags = spin_lock_irqsave(&eph->rdlock);
+  if (!epn->notified)
+    {
+      epn->notified = true;
+      list_add_tail(&eph->ready, &epn->rdnode);
+    }
+
+  spin_unlock_irqrestore(&eph->rdlock, flags);
+
   if (fds->revents != 0)
     {
       nxsem_get_value(&epn->eph->sem, &semcount);
@@ -582,6 +664,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 poll_fdsetup(fd, &epn->pfd, false);
+                epoll_unready(eph, epn);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
                 goto out;
@@ -619,6 +702,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
                     poll_fdsetup(fd, &epn->pfd, false);
+                    epoll_unready(eph, epn);
 
                     epn->notified    = false;
                     epn->data        = ev->data;
@@ -737,6 +821,12 @@ retry:
     {
       ret = -ETIMEDOUT;
     }
+  else if (!list_is_empty(&eph->ready))
+    {
+      /* Some fd are still ready from the last wait */
+
+      ret = OK;
+    }
   else if (timeout > 0)
     {
       ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
@@ -810,6 +900,12 @@ retry:
     {
       ret = -ETIMEDOUT;
     }
+  else if (!list_is_empty(&eph->ready))
+    {
+      /* Some fd are still ready from the last wait */
+
+      ret = OK;
+    }
   else if (timeout > 0)
     {
       ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
@@ -277,6 +277,7 @@ void poll_notify(FAR struct pollfd **afds, int nfds, pollevent_t eventset)
 {
   int i;
   FAR struct pollfd *fds;
+  bool exclusive = false;
 
   DEBUGASSERT(afds != NULL && nfds >= 1);
 
@@ -285,6 +286,20 @@ void poll_notify(FAR struct pollfd **afds, int nfds, pollevent_t eventset)
       fds = afds[i];
       if (fds != NULL)
         {
+          /* Only wake up the first exclusive waiter of the events */
+
+          if ((fds->events & POLLEXCLUSIVE) != 0 &&
+              (eventset & (POLLERR | POLLHUP)) == 0 &&
+              (eventset & fds->events) != 0)
+            {
+              if (exclusive)
+                {
+                  continue;
+                }
+
+              exclusive = true;
+            }
+
           /* The error event must be set in fds->revents */
 
           fds->revents |= eventset & (fds->events | POLLERR | POLLHUP);
@@ -242,6 +242,7 @@ next_subdir:
 
   oldinode->i_child  = NULL;
   oldinode->i_parent = NULL;
+  inode_cache_invalidate();
   ret = OK;
 
 errout_with_lock:
@@ -279,6 +279,21 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
     }
 #endif
 
+#ifdef CONFIG_PIPES
+  /* Data in a pipe can be written out straight from its buffer.  Pipes
+   * are not seekable, so leave an explicit offset to copyfile().
+   */
+
+  if (offset == NULL)
+    {
+      ssize_t ret = pipe_sendfile(outfile, infile, count);
+      if (ret != -ENOSYS)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* No... then this is probably a file-to-file transfer.  The generic
    * copyfile() can handle that case.
    */
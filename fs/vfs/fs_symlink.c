@@ -158,6 +158,7 @@ int symlink(FAR const char *path1, FAR const char *path2)
 
       INODE_SET_SOFTLINK(inode);
       inode->u.i_link = newpath2;
+      inode_cache_invalidate();
     }
 
   /* Symbolic link successfully created */
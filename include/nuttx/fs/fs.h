@@ -1856,6 +1856,31 @@ int file_pipe(FAR struct file *filep[2], size_t bufsize, int flags);
 int nx_mkfifo(FAR const char *pathname, mode_t mode, size_t bufsize);
 #endif
 
+/****************************************************************************
+ * Name: pipe_sendfile
+ *
+ * Description:
+ *   Transfer up to 'count' bytes from a pipe or FIFO to 'outfile'.  The
+ *   data is written to 'outfile' straight from the circular buffer of the
+ *   pipe, without being copied into an intermediate buffer.
+ *
+ * Input Parameters:
+ *   outfile - The file instance to write the data to
+ *   infile  - The file instance of the pipe to read the data from
+ *   count   - The maximum number of bytes to transfer
+ *
+ * Returned Value:
+ *   The number of bytes transferred on success, zero on end-of-file.
+ *   -ENOSYS is returned if 'infile' is not a pipe or if 'outfile' is the
+ *   same pipe; otherwise a negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES
+ssize_t pipe_sendfile(FAR struct file *outfile, FAR struct file *infile,
+                      size_t count);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -221,6 +221,11 @@ struct mod_loadinfo_s
   FAR Elf_Shdr *shdr;        /* Buffered module section headers */
   FAR void     *exported;    /* Module exports */
   FAR uint8_t  *iobuffer;    /* File I/O buffer */
+#ifdef CONFIG_LIBC_ELF_BULKBIND
+  FAR Elf_Sym  *symtab;      /* Symbol table held in memory while binding */
+  FAR char     *strtab;      /* String table of symtab */
+  FAR uint8_t  *symbound;    /* Bitmap of the resolved entries of symtab */
+#endif
   uintptr_t     datasec;     /* ET_DYN - data area start from Phdr */
   uintptr_t     segpad;      /* Padding between text and data */
   uintptr_t     initarr;     /* .init_array */
@@ -57,6 +57,12 @@
 #  define CONFIG_IOB_THROTTLE 0
 #endif
 
+/* Per-CPU cache of I/O buffers */
+
+#if !defined(CONFIG_IOB_PERCPU_CACHE)
+#  define CONFIG_IOB_PERCPU_CACHE 0
+#endif
+
 /* Some I/O buffers should be allocated */
 
 #if !defined(CONFIG_IOB_NBUFFERS)
@@ -170,6 +176,16 @@ struct iob_stats_s
   int nthrottle;
 };
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+struct iob_cachestats_s
+{
+  int ncached;       /* Number of IOBs in the cache */
+  uint32_t nhit;     /* Allocations served by the cache */
+  uint32_t nrefill;  /* Refills from the global free list */
+  uint32_t ndrain;   /* Returns to the global free list */
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -221,6 +237,20 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Try to allocate 'count' I/O buffers at once without waiting.  Each
+ *   I/O buffer is returned as a separate, empty chain in 'iobs'.
+ *
+ * Returned Value:
+ *   The number of I/O buffers allocated, which may be less than 'count'.
+ *
+ ****************************************************************************/
+
+int iob_alloc_batch(FAR struct iob_s **iobs, int count, bool throttled);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
@@ -289,6 +319,17 @@ int iob_navail(bool throttled);
 
 FAR struct iob_s *iob_free(FAR struct iob_s *iob);
 
+/****************************************************************************
+ * Name: iob_free_batch
+ *
+ * Description:
+ *   Free 'count' I/O buffer chains at once, returning all of their I/O
+ *   buffers to the pool together.
+ *
+ ****************************************************************************/
+
+void iob_free_batch(FAR struct iob_s **iobs, int count);
+
 /****************************************************************************
  * Name: iob_notifier_setup
  *
@@ -429,12 +470,16 @@ void iob_free_queue(FAR struct iob_queue_s *qhead);
  * Name: iob_free_queue_qentry
  *
  * Description:
- *   Free an iob entire queue of I/O buffer chains.
+ *   Remove the I/O buffer chain 'iob' from a queue and free it.
+ *
+ * Returned Value:
+ *   OK if the chain was found and freed; -ENOENT if it is not in the
+ *   queue.
  *
  ****************************************************************************/
 
 #if CONFIG_IOB_NCHAINS > 0
-void iob_free_queue_qentry(FAR struct iob_s *iob,
+int iob_free_queue_qentry(FAR struct iob_s *iob,
                            FAR struct iob_queue_s *iobq);
 #endif /* CONFIG_IOB_NCHAINS > 0 */
 
@@ -683,5 +728,24 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
 void iob_getstats(FAR struct iob_stats_s *stats);
 #endif
 
+/****************************************************************************
+ * Name: iob_getcachestats
+ *
+ * Description:
+ *   Return the statistics of the IOB cache of one CPU.
+ *
+ * Input Parameters:
+ *   cpu   - The CPU whose cache is inquired
+ *   stats - Location to return the statistics
+ *
+ * Returned Value:
+ *   OK on success, -EINVAL if there is no such CPU.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+int iob_getcachestats(int cpu, FAR struct iob_cachestats_s *stats);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* __INCLUDE_NUTTX_MM_IOB_H */
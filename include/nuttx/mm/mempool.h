@@ -49,6 +49,14 @@
 #  define MEMPOOL_REALBLOCKSIZE(pool) ((pool)->blocksize)
 #endif
 
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+#  ifdef CONFIG_SMP
+#    define MEMPOOL_CACHE_NCPUS CONFIG_SMP_NCPUS
+#  else
+#    define MEMPOOL_CACHE_NCPUS 1
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -87,6 +95,24 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+/* This structure describes the free block cache of one CPU in a memory
+ * pool.  It is only accessed by its own CPU with the local interrupts
+ * disabled, so it needs no lock.  The blocks in the cache are still
+ * counted in nalloc of the pool.
+ */
+
+struct mempool_cache_s
+{
+  size_t    count;   /* The number of blocks in blks[] */
+  size_t    nhit;    /* The number of allocations served by the cache */
+  size_t    nmiss;   /* The number of allocations that found it empty */
+  size_t    nrefill; /* The number of batches taken from the pool */
+  size_t    ndrain;  /* The number of batches given back to the pool */
+  FAR void *blks[CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE];
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -100,6 +126,9 @@ struct mempool_s
   mempool_alloc_t alloc;    /* The alloc function for mempool */
   mempool_free_t  free;     /* The free function for mempool */
   mempool_check_t check;    /* The check function for mempool */
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+  FAR struct mempool_cache_s *cache; /* MEMPOOL_CACHE_NCPUS caches or NULL */
+#endif
 
   /* Private data for memory pool */
 
@@ -137,6 +166,13 @@ struct mempoolinfo_s
   unsigned long aordblks; /* This is the number of used blocks */
   unsigned long sizeblks; /* This is the size of a mempool blocks */
   unsigned long nwaiter;  /* This is the number of waiter for mempool */
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+  unsigned long ncached;  /* This is the number of free blocks in the caches */
+  unsigned long nhit;     /* This is the number of cache hits */
+  unsigned long nmiss;    /* This is the number of cache misses */
+  unsigned long nrefill;  /* This is the number of cache refills */
+  unsigned long ndrain;   /* This is the number of cache drains */
+#endif
 };
 
 /****************************************************************************
@@ -160,6 +196,10 @@ extern "C"
  *   The user needs to specify the initialization information of mempool
  *   including blocksize, initialsize, expandsize, interruptsize.
  *
+ *   If CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0, cache either points to
+ *   MEMPOOL_CACHE_NCPUS zeroed per-CPU caches or is NULL.  The caches are
+ *   not used by pools that wait for free blocks.
+ *
  * Input Parameters:
  *   pool - Address of the memory pool to be used.
  *   name - The name of memory pool.
@@ -36,6 +36,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <mqueue.h>
 #include <poll.h>
 
@@ -94,6 +95,15 @@
 #  define MQ_WNELIST(cmn)             (&((cmn).waitfornotempty))
 #  define MQ_WNFLIST(cmn)             (&((cmn).waitfornotfull))
 
+/* Geometry of the priority index of a message queue, it covers every
+ * value of the 8-bit message priority.
+ */
+
+#ifdef CONFIG_MQ_PRIO_INDEX
+#  define MQINDEX_NPRIO               (UCHAR_MAX + 1)
+#  define MQINDEX_NWORDS              ((MQINDEX_NPRIO + 31) >> 5)
+#endif
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
@@ -108,6 +118,26 @@ struct mqueue_cmn_s
   int16_t nwaitnotempty;      /* Number tasks waiting for not empty */
 };
 
+#ifdef CONFIG_MQ_PRIO_INDEX
+/* This structure indexes the message list of a message queue by priority.
+ * It records the last message of each priority present in the list so
+ * that the insertion point of a new message can be found with two
+ * find-first-set operations instead of a list walk.
+ */
+
+struct mqueue_msg_s;  /* Forward reference */
+
+struct mqueue_index_s
+{
+  uint32_t summary;             /* One bit per non-zero map[] word */
+  uint32_t map[MQINDEX_NWORDS]; /* One bit per non-empty priority */
+
+  /* The last message of each priority */
+
+  FAR struct mqueue_msg_s *tail[MQINDEX_NPRIO];
+};
+#endif
+
 /* This structure defines a message queue */
 
 struct mqueue_inode_s
@@ -115,6 +145,9 @@ struct mqueue_inode_s
   struct mqueue_cmn_s cmn;    /* Common prologue */
   FAR struct inode *inode;    /* Containing inode */
   struct list_node msglist;   /* Prioritized message list */
+#ifdef CONFIG_MQ_PRIO_INDEX
+  struct mqueue_index_s index; /* Priority index of msglist */
+#endif
   int16_t maxmsgs;            /* Maximum number of messages in the queue */
   int16_t nmsgs;              /* Number of message in the queue */
 #if CONFIG_MQ_MAXMSGSIZE < 256
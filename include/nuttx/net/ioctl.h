@@ -154,6 +154,12 @@
 
 #define SIOCNOTIFYRECVCPU  _SIOC(0x003F)  /* RSS notify recv cpu */
 
+/* Zero-copy receive ********************************************************/
+
+#define SIOCRECVIOB        _SIOC(0x0043)  /* Lend the I/O buffers of the next
+                                           * datagram, see struct udp_iob_s */
+#define SIOCFREEIOB        _SIOC(0x0044)  /* Return a lent I/O buffer chain */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
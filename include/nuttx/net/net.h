@@ -94,6 +94,26 @@
 #define _PS_INITD(psock)    (_SS_INITD((psock)->s_flags))
 #define _PS_VALID(psock)    (_PS_ALLOCD(psock) && _PS_INITD(psock))
 
+/* Per-connection lock.  With CONFIG_NET_FINE_GRAINED_LOCK, the state that
+ * is shared between the socket interface and the input path of a
+ * connection (such as the UDP read-ahead queue) is protected by a lock of
+ * its own, so that it can be accessed without holding the network lock.
+ * The network lock, if also needed, must be taken first.
+ */
+
+#ifdef CONFIG_NET_FINE_GRAINED_LOCK
+#  define _CONN_LOCK(c)        (&((FAR struct socket_conn_s *)(c))->s_lock)
+#  define conn_lock_init(c)    nxrmutex_init(_CONN_LOCK(c))
+#  define conn_lock_destroy(c) nxrmutex_destroy(_CONN_LOCK(c))
+#  define conn_lock(c)         nxrmutex_lock(_CONN_LOCK(c))
+#  define conn_unlock(c)       nxrmutex_unlock(_CONN_LOCK(c))
+#else
+#  define conn_lock_init(c)
+#  define conn_lock_destroy(c)
+#  define conn_lock(c)
+#  define conn_unlock(c)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -234,6 +254,11 @@ struct socket_conn_s
   uint8_t       s_ttl;       /* Default time-to-live */
 #endif
 
+#ifdef CONFIG_NET_FINE_GRAINED_LOCK
+  rmutex_t      s_lock;      /* Protects connection state shared with the
+                              * input path.  See conn_lock() */
+#endif
+
   /* Connection-specific content may follow */
 };
 
@@ -928,6 +953,66 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends multiple messages to a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to sendmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send
+ *   vlen      The number of messages in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  If the first message
+ *   cannot be sent, a negated errno value is returned (see comments with
+ *   sendmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives multiple messages from a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to recvmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Buffers to receive the messages
+ *   vlen      The number of messages in msgvec
+ *   flags     Receive flags
+ *   timeout   The maximum time to spend receiving, NULL to not time out
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  If the first
+ *   message cannot be received, a negated errno value is returned (see
+ *   comments with recvmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -99,6 +99,18 @@
 #  define RADIO_MAX_ADDRLEN CONFIG_PKTRADIO_ADDRLEN
 #endif
 
+/* Per-device lock, see d_lock.  The network lock, if also needed, must be
+ * taken first.
+ */
+
+#ifdef CONFIG_NET_FINE_GRAINED_LOCK
+#  define netdev_lock(dev)    nxrmutex_lock(&(dev)->d_lock)
+#  define netdev_unlock(dev)  nxrmutex_unlock(&(dev)->d_lock)
+#else
+#  define netdev_lock(dev)
+#  define netdev_unlock(dev)
+#endif
+
 /* Helper macros for network device statistics */
 
 #ifdef CONFIG_NETDEV_STATISTICS
@@ -528,6 +540,14 @@ struct net_driver_s
   FAR struct devif_callback_s *d_conncb_tail; /* This is the list tail */
   FAR struct devif_callback_s *d_devcb;
 
+#ifdef CONFIG_NET_FINE_GRAINED_LOCK
+  /* Serializes access to the driver so that packets can be exchanged with
+   * the device without holding the network lock.
+   */
+
+  rmutex_t d_lock;
+#endif
+
   /* Driver callbacks */
 
   CODE int (*d_ifup)(FAR struct net_driver_s *dev);
@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <sys/socket.h>
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/ip.h>
@@ -92,6 +93,20 @@ struct udp_stats_s
 };
 #endif
 
+/* The argument of the SIOCRECVIOB ioctl.  On success, ui_iob holds the
+ * payload of the received datagram, starting at the beginning of the chain.
+ * The chain must be given back with the SIOCFREEIOB ioctl.
+ */
+
+struct iob_s;  /* Forward reference */
+
+struct udp_iob_s
+{
+  FAR struct iob_s *ui_iob;         /* Lent I/O buffer chain */
+  socklen_t ui_fromlen;             /* Size of the source address */
+  struct sockaddr_storage ui_from;  /* Source address of the datagram */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -31,6 +31,7 @@
 #include <nuttx/fs/ioctl.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 /****************************************************************************
@@ -54,6 +55,11 @@
  * NOTERAM_SETREADMODE
  *              - Set read mode
  *                Argument: A read-only pointer to unsigned int
+ * NOTERAM_GETLOST
+ *              - Get the number of notes that were overwritten or dropped
+ *                before they could be read (CONFIG_DRIVERS_NOTERAM_PERCPU
+ *                only)
+ *                Argument: A writable pointer to unsigned long
  */
 
 #ifdef CONFIG_DRIVERS_NOTERAM
@@ -62,6 +68,7 @@
 #define NOTERAM_SETMODE         _NOTERAMIOC(0x03)
 #define NOTERAM_GETREADMODE     _NOTERAMIOC(0x04)
 #define NOTERAM_SETREADMODE     _NOTERAMIOC(0x05)
+#define NOTERAM_GETLOST         _NOTERAMIOC(0x06)
 #endif
 
 /* Overwrite mode definitions */
@@ -81,6 +88,35 @@
 
 struct noteram_driver_s;
 
+/* With CONFIG_DRIVERS_NOTERAM_PERCPU, the note buffer is split into one
+ * ring per CPU.  Each CPU only adds notes to its own ring, without taking
+ * any lock.  The buffer starts with an array of CONFIG_SMP_NCPUS ring
+ * descriptors, followed by the ring data.  The whole buffer can be mapped
+ * read-only with mmap() and parsed in place:
+ *
+ *   - The notes of a ring lie between the free-running byte positions
+ *     nr_tail (or nr_start, if later) and nr_head.  The byte at position
+ *     'pos' is at offset nr_offset + (pos & (nr_size - 1)) of the buffer.
+ *   - A note may wrap around the end of the ring.  Its length is given by
+ *     its first byte and it is followed by padding up to NOTE_ALIGN().
+ *   - A note that was copied out is valid only if nr_tail has not passed
+ *     its position after the copy.
+ *   - Notes of different rings are merged by their nc_systime.
+ */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+struct noteram_ring_s
+{
+  uint32_t nr_offset;               /* Offset of the ring data in buffer */
+  uint32_t nr_size;                 /* Size of the ring data, power of 2 */
+  volatile uint32_t nr_head;        /* Position where the next note goes */
+  volatile uint32_t nr_tail;        /* Position of the oldest note */
+  volatile uint32_t nr_start;       /* Position where the ring was cleared */
+  volatile uint32_t nr_read;        /* Position of the next note to read */
+  volatile uint32_t nr_lost;        /* Notes lost before they were read */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -648,6 +648,9 @@ struct tcb_s
   /* POSIX Semaphore and Message Queue Control Fields ***********************/
 
   FAR void *waitobj;                     /* Object thread waiting on        */
+#ifdef CONFIG_MQ_RECEIVE_HANDOFF
+  FAR void *waitbuf;                     /* Message queue receive buffer    */
+#endif
 
   /* POSIX Signal Control Fields ********************************************/
 
@@ -282,6 +282,11 @@
 /* Command:      SNIOC_BATCH
  * Description:  Set batch latency between batch data.
  * Argument:     This is the latency pointer, in microseconds
+ * Note:         Once a subscriber has set an interval and a latency, its
+ *               poll() and blocking read() wakeups are batched: they are
+ *               held back until its oldest unread sample is 'latency' old,
+ *               or its samples start to be overwritten.  Without work
+ *               queue support, the subscriber is woken on every sample.
  */
 
 #define SNIOC_BATCH                _SNIOC(0x0082)
@@ -498,6 +503,16 @@
 
 #define SNIOC_GET_CALIBVALUE          _SNIOC(0x00A3)
 
+#ifdef CONFIG_SENSORS_SHARED_RING
+/* Command:      SNIOC_CONSUME
+ * Description:  Mark the samples of the mapped ring before the given index
+ *               as read, see struct sensor_ring_s.
+ * Argument:     The index of the next sample to read, (uint32_t)
+ */
+
+#  define SNIOC_CONSUME               _SNIOC(0x00A4)
+#endif
+
 /****************************************************************************
  * Public types
  ****************************************************************************/
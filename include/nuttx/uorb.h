@@ -1182,6 +1182,35 @@ struct sensor_ustate_s
   uint64_t generation;         /* The recent generation of circular buffer */
 };
 
+/* With CONFIG_SENSORS_SHARED_RING, the circular buffer of a topic can be
+ * mapped read-only with mmap() and the samples read in place, without a
+ * copy through read().  The mapping starts with this header, followed by
+ * the generation of each sample at offset timing and the samples at
+ * offset data:
+ *
+ *   - Samples are numbered by a free-running index.  Sample 'i' is at
+ *     offset data + (i % nbuffer) * esize and its generation is element
+ *     (i % nbuffer) of the uint32_t array at offset timing.
+ *   - The published samples lie between reserve - nbuffer (or 0, if
+ *     larger) and head.
+ *   - A sample that was copied out is valid only if reserve - i is still
+ *     not larger than nbuffer after the copy.
+ *   - SNIOC_CONSUME tells the driver the index of the next sample the user
+ *     will read, so that poll() only reports newer samples.
+ */
+
+#ifdef CONFIG_SENSORS_SHARED_RING
+struct sensor_ring_s
+{
+  uint32_t esize;              /* The element size of circular buffer */
+  uint32_t nbuffer;            /* The number of samples in the ring */
+  uint32_t timing;             /* The offset of the generation array */
+  uint32_t data;               /* The offset of the sample array */
+  volatile uint32_t head;      /* The index of the next sample published */
+  volatile uint32_t reserve;   /* The index past the samples being written */
+};
+#endif
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
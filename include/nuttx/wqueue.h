@@ -262,7 +262,30 @@ struct work_s
   worker_t  worker;              /* Work callback */
   FAR void *arg;                 /* Callback argument */
   FAR struct kwork_wqueue_s *wq; /* Work queue */
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  FAR struct dq_queue_s *pending; /* Pending list holding the work */
+#endif
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  clock_t   stime;               /* Time put on the pending list */
+#endif
+};
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+/* The statistics of one kernel-mode work queue.  Times are in the units
+ * of perf_gettime().
+ */
+
+struct work_stats_s
+{
+  uint32_t nqueued;              /* Work put on the pending list */
+  uint32_t ndone;                /* Work performed */
+  uint32_t nstolen;              /* Work taken from another worker */
+  uint64_t totalwait;            /* Total time pending */
+  clock_t  maxwait;              /* Maximum time pending */
+  uint64_t totalrun;             /* Total time running the workers */
+  clock_t  maxrun;               /* Maximum time running one worker */
 };
+#endif
 
 /* This is an enumeration of the various events that may be
  * notified via work_notifier_signal().
@@ -473,6 +496,28 @@ int work_queue_period_wq(FAR struct kwork_wqueue_s *wqueue,
 int work_queue_priority(int qid);
 int work_queue_priority_wq(FAR struct kwork_wqueue_s *wqueue);
 
+/****************************************************************************
+ * Name: work_queue_getstats/work_queue_getstats_wq
+ *
+ * Description:
+ *   Return the statistics of a kernel-mode work queue.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   stats  - Location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+int work_queue_getstats(int qid, FAR struct work_stats_s *stats);
+int work_queue_getstats_wq(FAR struct kwork_wqueue_s *wqueue,
+                           FAR struct work_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: work_cancel/work_cancel_wq
  *
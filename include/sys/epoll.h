@@ -81,6 +81,8 @@ enum EPOLL_EVENTS
 #define EPOLLHUP EPOLLHUP
     EPOLLRDHUP = POLLRDHUP,
 #define EPOLLRDHUP EPOLLRDHUP
+    EPOLLEXCLUSIVE = POLLEXCLUSIVE,
+#define EPOLLEXCLUSIVE EPOLLEXCLUSIVE
     EPOLLWAKEUP = 1u << 29,
 #define EPOLLWAKEUP EPOLLWAKEUP
     EPOLLONESHOT = 1u << 30,
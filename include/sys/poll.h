@@ -68,6 +68,11 @@
  *     Indicate that should ALWAYS call the poll callback whether the
  *     drvier notified the user expected event or not, and this value is
  *     used inside kernal only (events only).
+ *   POLLEXCLUSIVE
+ *     Indicate that the callback is skipped if the callback of another
+ *     exclusive pollfd was already called for the same notification, unless
+ *     an error or hang up is notified.  This is used inside kernel only to
+ *     implement EPOLLEXCLUSIVE (events only).
  */
 
 #define POLLIN       (0x01)  /* NuttX does not make priority distinctions */
@@ -85,7 +90,8 @@
 #define POLLRDHUP    (0x10)  /* NuttX does not support shutdown(fd, SHUT_RD) */
 #define POLLNVAL     (0x20)
 
-#define POLLALWAYS   (0x10000) /* For not conflict with Linux */
+#define POLLALWAYS    (0x10000)    /* For not conflict with Linux */
+#define POLLEXCLUSIVE (0x10000000) /* Same value as EPOLLEXCLUSIVE */
 
 /****************************************************************************
  * Public Type Definitions
@@ -115,6 +115,78 @@ int libelf_symvalue(FAR struct module_s *modp,
                     Elf_Off sh_offset,
                     FAR const struct symtab_s *exports, int nexports);
 
+/****************************************************************************
+ * Name: libelf_findexport
+ *
+ * Description:
+ *   Find a symbol exported by the base code, through the hash index of the
+ *   kernel symbol table if CONFIG_LIBC_ELF_HASHED_EXPORTS is enabled.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry, or NULL if the symbol is not
+ *   exported.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+libelf_findexport(FAR const struct symtab_s *exports,
+                  FAR const char *name, int nexports);
+
+#ifdef CONFIG_LIBC_ELF_BULKBIND
+/****************************************************************************
+ * Name: libelf_cachesymtab
+ *
+ * Description:
+ *   Read the whole symbol table and its string table into memory, so that
+ *   libelf_bindsym() can resolve each symbol without further file access.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.  On failure, nothing is kept in memory.
+ *
+ ****************************************************************************/
+
+int libelf_cachesymtab(FAR struct mod_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: libelf_uncachesymtab
+ *
+ * Description:
+ *   Free the tables read by libelf_cachesymtab().
+ *
+ ****************************************************************************/
+
+void libelf_uncachesymtab(FAR struct mod_loadinfo_s *loadinfo);
+
+/****************************************************************************
+ * Name: libelf_bindsym
+ *
+ * Description:
+ *   Return the entry of the symbol table read by libelf_cachesymtab() at the
+ *   specified index.  The value of the symbol is resolved with
+ *   libelf_symvalue() the first time the entry is used, later uses return
+ *   the resolved entry.
+ *
+ * Input Parameters:
+ *   modp     - Module state information
+ *   loadinfo - Load state information
+ *   index    - Symbol table index
+ *   sym      - Location to return the table entry
+ *   exports  - Pointer to the symbol table
+ *   nexports - Number of symbols in the symbol table
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.  See libelf_symvalue().
+ *
+ ****************************************************************************/
+
+int libelf_bindsym(FAR struct module_s *modp,
+                   FAR struct mod_loadinfo_s *loadinfo, int index,
+                   FAR Elf_Sym **sym,
+                   FAR const struct symtab_s *exports, int nexports);
+#endif
+
 /****************************************************************************
  * Name: libelf_insertsymtab
  *
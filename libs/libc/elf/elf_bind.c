@@ -189,6 +189,7 @@ static int libelf_relocate(FAR struct module_s *modp,
   FAR dq_entry_t   *e;
   dq_queue_t        q;
   uintptr_t         addr;
+  size_t            bufcount;
   int               symidx;
   int               ret = OK;
   int               i;
@@ -198,8 +199,27 @@ static int libelf_relocate(FAR struct module_s *modp,
 
   ARCH_ELFDATA_DEF;
 
-  rels = lib_malloc(CONFIG_LIBC_ELF_RELOCATION_BUFFERCOUNT *
-                    sizeof(Elf_Rel));
+  rels     = NULL;
+  bufcount = CONFIG_LIBC_ELF_RELOCATION_BUFFERCOUNT;
+
+#ifdef CONFIG_LIBC_ELF_BULKBIND
+  /* Read the whole section at once if there is memory for it */
+
+  if (relsec->sh_size > bufcount * sizeof(Elf_Rel))
+    {
+      rels = lib_malloc(relsec->sh_size);
+      if (rels != NULL)
+        {
+          bufcount = relsec->sh_size / sizeof(Elf_Rel);
+        }
+    }
+
+  if (rels == NULL)
+#endif
+    {
+      rels = lib_malloc(bufcount * sizeof(Elf_Rel));
+    }
+
   if (!rels)
     {
       berr("Failed to allocate memory for elf relocation rels\n");
@@ -217,12 +237,11 @@ static int libelf_relocate(FAR struct module_s *modp,
     {
       /* Read the relocation entry into memory */
 
-      rel = &rels[i % CONFIG_LIBC_ELF_RELOCATION_BUFFERCOUNT];
+      rel = &rels[i % bufcount];
 
-      if (!(i % CONFIG_LIBC_ELF_RELOCATION_BUFFERCOUNT))
+      if (!(i % bufcount))
         {
-          ret = libelf_readrels(loadinfo, relsec, i, rels,
-                                CONFIG_LIBC_ELF_RELOCATION_BUFFERCOUNT);
+          ret = libelf_readrels(loadinfo, relsec, i, rels, bufcount);
           if (ret < 0)
             {
               berr("ERROR: Section %d reloc %d: "
@@ -238,9 +257,27 @@ static int libelf_relocate(FAR struct module_s *modp,
 
       symidx = ELF_R_SYM(rel->r_info);
 
+      sym = NULL;
+
+#ifdef CONFIG_LIBC_ELF_BULKBIND
+      /* With the symbol table in memory, the cache below stays empty */
+
+      if (loadinfo->symtab != NULL)
+        {
+          ret = libelf_bindsym(modp, loadinfo, symidx, &sym,
+                               exports, nexports);
+          if (ret < 0 && ret != -ESRCH)
+            {
+              berr("ERROR: Section %d reloc %d: "
+                   "Failed to get value of symbol[%d]: %d\n",
+                   relidx, i, symidx, ret);
+              break;
+            }
+        }
+#endif
+
       /* First try the cache */
 
-      sym = NULL;
       for (e = dq_peek(&q); e; e = dq_next(e))
         {
           cache = (FAR Elf_SymCache *)e;
@@ -441,6 +478,7 @@ static int libelf_relocateadd(FAR struct module_s *modp,
   FAR dq_entry_t   *e;
   dq_queue_t        q;
   uintptr_t         addr;
+  size_t            bufcount;
   int               symidx;
   int               ret = OK;
   int               i;
@@ -450,8 +488,27 @@ static int libelf_relocateadd(FAR struct module_s *modp,
 
   ARCH_ELFDATA_DEF;
 
-  relas = lib_malloc(CONFIG_LIBC_ELF_RELOCATION_BUFFERCOUNT *
-                     sizeof(Elf_Rela));
+  relas    = NULL;
+  bufcount = CONFIG_LIBC_ELF_RELOCATION_BUFFERCOUNT;
+
+#ifdef CONFIG_LIBC_ELF_BULKBIND
+  /* Read the whole section at once if there is memory for it */
+
+  if (relsec->sh_size > bufcount * sizeof(Elf_Rela))
+    {
+      relas = lib_malloc(relsec->sh_size);
+      if (relas != NULL)
+        {
+          bufcount = relsec->sh_size / sizeof(Elf_Rela);
+        }
+    }
+
+  if (relas == NULL)
+#endif
+    {
+      relas = lib_malloc(bufcount * sizeof(Elf_Rela));
+    }
+
   if (!relas)
     {
       berr("Failed to allocate memory for elf relocation relas\n");
@@ -469,12 +526,11 @@ static int libelf_relocateadd(FAR struct module_s *modp,
     {
       /* Read the relocation entry into memory */
 
-      rela = &relas[i % CONFIG_LIBC_ELF_RELOCATION_BUFFERCOUNT];
+      rela = &relas[i % bufcount];
 
-      if (!(i % CONFIG_LIBC_ELF_RELOCATION_BUFFERCOUNT))
+      if (!(i % bufcount))
         {
-          ret = libelf_readrelas(loadinfo, relsec, i, relas,
-                                 CONFIG_LIBC_ELF_RELOCATION_BUFFERCOUNT);
+          ret = libelf_readrelas(loadinfo, relsec, i, relas, bufcount);
           if (ret < 0)
             {
               berr("ERROR: Section %d reloc %d: "
@@ -490,9 +546,27 @@ static int libelf_relocateadd(FAR struct module_s *modp,
 
       symidx = ELF_R_SYM(rela->r_info);
 
+      sym = NULL;
+
+#ifdef CONFIG_LIBC_ELF_BULKBIND
+      /* With the symbol table in memory, the cache below stays empty */
+
+      if (loadinfo->symtab != NULL)
+        {
+          ret = libelf_bindsym(modp, loadinfo, symidx, &sym,
+                               exports, nexports);
+          if (ret < 0 && ret != -ESRCH)
+            {
+              berr("ERROR: Section %d reloc %d: "
+                   "Failed to get value of symbol[%d]: %d\n",
+                   relidx, i, symidx, ret);
+              break;
+            }
+        }
+#endif
+
       /* First try the cache */
 
-      sym = NULL;
       for (e = dq_peek(&q); e; e = dq_next(e))
         {
           cache = (FAR Elf_SymCache *)e;
@@ -943,6 +1017,18 @@ int libelf_bind(FAR struct module_s *modp,
       goto errout_with_addrenv;
     }
 
+#ifdef CONFIG_LIBC_ELF_BULKBIND
+  /* Keep the symbol table of a relocatable module in memory while binding
+   * it.  Without the memory for that, symbols are read one at a time.
+   */
+
+  if (loadinfo->ehdr.e_type == ET_REL &&
+      libelf_cachesymtab(loadinfo) < 0)
+    {
+      bwarn("WARNING: Binding without the symbol table in memory\n");
+    }
+#endif
+
   /* Process relocations in every allocated section */
 
   for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
@@ -1080,6 +1166,10 @@ int libelf_bind(FAR struct module_s *modp,
 
 errout_with_addrenv:
 
+#ifdef CONFIG_LIBC_ELF_BULKBIND
+  libelf_uncachesymtab(loadinfo);
+#endif
+
 #ifdef CONFIG_ARCH_ADDRENV
   if (loadinfo->addrenv != NULL)
     {
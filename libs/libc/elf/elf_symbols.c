@@ -80,7 +80,8 @@ extern int nglobals;
  * Name: libelf_symname
  *
  * Description:
- *   Get the symbol name in loadinfo->iobuffer[].
+ *   Get the symbol name.  It is returned in 'name', which points either
+ *   into the string table held in memory or to loadinfo->iobuffer[].
  *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
@@ -93,8 +94,12 @@ extern int nglobals;
  ****************************************************************************/
 
 static int libelf_symname(FAR struct mod_loadinfo_s *loadinfo,
-                          FAR const Elf_Sym *sym, Elf_Off sh_offset)
+                          FAR const Elf_Sym *sym, Elf_Off sh_offset,
+                          FAR const char **name)
 {
+#ifdef CONFIG_LIBC_ELF_BULKBIND
+  FAR const Elf_Shdr *strtab;
+#endif
   FAR uint8_t *buffer;
   off_t  offset;
   size_t readlen;
@@ -111,6 +116,23 @@ static int libelf_symname(FAR struct mod_loadinfo_s *loadinfo,
       return -ESRCH;
     }
 
+#ifdef CONFIG_LIBC_ELF_BULKBIND
+  /* Is the string table already in memory? */
+
+  strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  if (loadinfo->strtab != NULL && sh_offset == strtab->sh_offset)
+    {
+      if (sym->st_name >= strtab->sh_size)
+        {
+          berr("ERROR: Symbol name beyond the string table\n");
+          return -EINVAL;
+        }
+
+      *name = &loadinfo->strtab[sym->st_name];
+      return OK;
+    }
+#endif
+
   /* Allocate an I/O buffer.  This buffer is used by mod_symname() to
    * accumulate the variable length symbol name.
    */
@@ -162,6 +184,7 @@ static int libelf_symname(FAR struct mod_loadinfo_s *loadinfo,
         {
           /* Yes, the buffer contains a NUL terminator. */
 
+          *name = (FAR const char *)loadinfo->iobuffer;
           return OK;
         }
 
@@ -369,7 +392,7 @@ int libelf_symvalue(FAR struct module_s *modp,
       {
         /* Get the name of the undefined symbol */
 
-        ret = libelf_symname(loadinfo, sym, sh_offset);
+        ret = libelf_symname(loadinfo, sym, sh_offset, &exportinfo.name);
         if (ret < 0)
           {
             /* There are a few relocations for a few architectures that do
@@ -388,7 +411,6 @@ int libelf_symvalue(FAR struct module_s *modp,
          * recently installed will take precedence.
          */
 
-        exportinfo.name   = (FAR const char *)loadinfo->iobuffer;
         exportinfo.modp   = modp;
         exportinfo.symbol = NULL;
 
@@ -408,7 +430,7 @@ int libelf_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            symbol = symtab_findbyname(exports, exportinfo.name,
+            symbol = libelf_findexport(exports, exportinfo.name,
                                        nexports);
           }
 
@@ -417,7 +439,7 @@ int libelf_symvalue(FAR struct module_s *modp,
         if (symbol == NULL)
           {
             berr("ERROR: SHN_UNDEF: Exported symbol \"%s\" not found\n",
-                 loadinfo->iobuffer);
+                 exportinfo.name);
             return -ENOENT;
           }
 
@@ -427,7 +449,7 @@ int libelf_symvalue(FAR struct module_s *modp,
 
         binfo("SHN_UNDEF: name=%s "
               "%08" PRIxPTR "+%08" PRIxPTR "=%08" PRIxPTR "\n",
-              loadinfo->iobuffer,
+              exportinfo.name,
               (uintptr_t)sym->st_value, (uintptr_t)symbol->sym_value,
               (uintptr_t)(sym->st_value + (uintptr_t)symbol->sym_value));
 
@@ -456,6 +478,131 @@ int libelf_symvalue(FAR struct module_s *modp,
   return OK;
 }
 
+#ifdef CONFIG_LIBC_ELF_BULKBIND
+/****************************************************************************
+ * Name: libelf_cachesymtab
+ *
+ * Description:
+ *   Read the whole symbol table and its string table into memory.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int libelf_cachesymtab(FAR struct mod_loadinfo_s *loadinfo)
+{
+  FAR Elf_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  FAR Elf_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  size_t nsyms = symtab->sh_size / sizeof(Elf_Sym);
+  int ret;
+
+  /* One more byte terminates the last name, should the string table be
+   * corrupted.
+   */
+
+  loadinfo->symtab   = lib_malloc(symtab->sh_size);
+  loadinfo->strtab   = lib_malloc(strtab->sh_size + 1);
+  loadinfo->symbound = lib_zalloc((nsyms + 7) / 8);
+  if (loadinfo->symtab == NULL || loadinfo->strtab == NULL ||
+      loadinfo->symbound == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ret = libelf_read(loadinfo, (FAR uint8_t *)loadinfo->symtab,
+                    symtab->sh_size, symtab->sh_offset);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = libelf_read(loadinfo, (FAR uint8_t *)loadinfo->strtab,
+                    strtab->sh_size, strtab->sh_offset);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  loadinfo->strtab[strtab->sh_size] = '\0';
+  return OK;
+
+errout:
+  libelf_uncachesymtab(loadinfo);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: libelf_uncachesymtab
+ *
+ * Description:
+ *   Free the tables read by libelf_cachesymtab().
+ *
+ ****************************************************************************/
+
+void libelf_uncachesymtab(FAR struct mod_loadinfo_s *loadinfo)
+{
+  lib_free(loadinfo->symtab);
+  lib_free(loadinfo->strtab);
+  lib_free(loadinfo->symbound);
+
+  loadinfo->symtab   = NULL;
+  loadinfo->strtab   = NULL;
+  loadinfo->symbound = NULL;
+}
+
+/****************************************************************************
+ * Name: libelf_bindsym
+ *
+ * Description:
+ *   Return the in-memory symbol table entry at the specified index,
+ *   resolving its value the first time it is used.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int libelf_bindsym(FAR struct module_s *modp,
+                   FAR struct mod_loadinfo_s *loadinfo, int index,
+                   FAR Elf_Sym **sym,
+                   FAR const struct symtab_s *exports, int nexports)
+{
+  FAR Elf_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  uint8_t mask = 1 << (index & 7);
+  int ret = OK;
+
+  if (index < 0 || index >= symtab->sh_size / sizeof(Elf_Sym))
+    {
+      berr("ERROR: Bad relocation symbol index: %d\n", index);
+      return -EINVAL;
+    }
+
+  *sym = &loadinfo->symtab[index];
+  if ((loadinfo->symbound[index >> 3] & mask) == 0)
+    {
+      /* Resolve the value only once, libelf_symvalue() updates it in
+       * place.  A nameless symbol (-ESRCH) is left as it is.
+       */
+
+      ret = libelf_symvalue(modp, loadinfo, *sym,
+                            loadinfo->shdr[loadinfo->strtabidx].sh_offset,
+                            exports, nexports);
+      if (ret < 0 && ret != -ESRCH)
+        {
+          return ret;
+        }
+
+      loadinfo->symbound[index >> 3] |= mask;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: libelf_insertsymtab
  *
@@ -483,6 +630,7 @@ int libelf_insertsymtab(FAR struct module_s *modp,
 {
   FAR struct symtab_s *symbol;
   FAR Elf_Shdr *strtab = &loadinfo->shdr[shdr->sh_link];
+  FAR const char *name;
   int ret = 0;
   int i;
   int j;
@@ -526,7 +674,8 @@ int libelf_insertsymtab(FAR struct module_s *modp,
                   ELF_ST_TYPE(sym[i].st_info) != STT_NOTYPE &&
                   ELF_ST_VISIBILITY(sym[i].st_other) == STV_DEFAULT)
                 {
-                  ret = libelf_symname(loadinfo, &sym[i], strtab->sh_offset);
+                  ret = libelf_symname(loadinfo, &sym[i], strtab->sh_offset,
+                                       &name);
                   if (ret < 0)
                     {
                       lib_free((FAR void *)modp->modinfo.exports);
@@ -534,8 +683,7 @@ int libelf_insertsymtab(FAR struct module_s *modp,
                       return ret;
                     }
 
-                  symbol[j].sym_name =
-                      strdup((FAR char *)loadinfo->iobuffer);
+                  symbol[j].sym_name = strdup(name);
                   symbol[j].sym_value =
                       (FAR const void *)(uintptr_t)sym[i].st_value;
                   j++;
@@ -591,17 +739,18 @@ void *libelf_findglobal(FAR struct module_s *modp,
                         FAR Elf_Shdr *shdr, FAR Elf_Sym *sym)
 {
   FAR Elf_Shdr *strtab = &loadinfo->shdr[shdr->sh_link];
+  FAR const char *name;
   int ret;
   struct eptable_s key;
   FAR struct eptable_s *res;
 
-  ret = libelf_symname(loadinfo, sym, strtab->sh_offset);
+  ret = libelf_symname(loadinfo, sym, strtab->sh_offset, &name);
   if (ret < 0)
     {
       return NULL;
     }
 
-  key.epname = loadinfo->iobuffer;
+  key.epname = (FAR uint8_t *)name;
   res = bsearch(&key, global_table, nglobals,
                 sizeof(struct eptable_s), findep);
   if (res != NULL)
@@ -26,11 +26,17 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <string.h>
 #include <assert.h>
+#include <errno.h>
 
 #include <nuttx/symtab.h>
 #include <nuttx/lib/elf.h>
 
+#include "libc.h"
+#include "elf/elf.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -65,6 +71,89 @@ extern int CONFIG_LIBC_ELF_NSYMBOLS_VAR;
 static FAR const struct symtab_s *g_libelf_symtab;
 static int g_libelf_nsymbols;
 
+#ifdef CONFIG_LIBC_ELF_HASHED_EXPORTS
+/* Hash index of the kernel symbol table.  Each slot holds the index of a
+ * symbol plus one, zero marks an empty slot.  It is built at the first
+ * lookup after the symbol table was selected.
+ */
+
+static FAR uint32_t *g_libelf_symhash;
+static uint32_t g_libelf_symmask;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_ELF_HASHED_EXPORTS
+/****************************************************************************
+ * Name: libelf_hashname
+ *
+ * Description:
+ *   The hash function of DT_GNU_HASH.
+ *
+ ****************************************************************************/
+
+static uint32_t libelf_hashname(FAR const char *name)
+{
+  uint32_t hash = 5381;
+
+  while (*name != '\0')
+    {
+      hash = (hash << 5) + hash + (uint8_t)*name++;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: libelf_buildhash
+ *
+ * Description:
+ *   Build the hash index of the kernel symbol table.  The table is open
+ *   addressed and at most half full.
+ *
+ * Returned Value:
+ *   0 (OK) on success; -ENOMEM if the index cannot be allocated.
+ *
+ * Assumptions:
+ *   The caller holds the registry lock.
+ *
+ ****************************************************************************/
+
+static int libelf_buildhash(void)
+{
+  uint32_t size = 2;
+  uint32_t slot;
+  int i;
+
+  while (size < 2 * (uint32_t)g_libelf_nsymbols)
+    {
+      size <<= 1;
+    }
+
+  g_libelf_symhash = lib_zalloc(size * sizeof(uint32_t));
+  if (g_libelf_symhash == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  g_libelf_symmask = size - 1;
+  for (i = 0; i < g_libelf_nsymbols; i++)
+    {
+      slot = libelf_hashname(g_libelf_symtab[i].sym_name);
+      while (g_libelf_symhash[slot & g_libelf_symmask] != 0)
+        {
+          slot++;
+        }
+
+      g_libelf_symhash[slot & g_libelf_symmask] = i + 1;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -127,5 +216,88 @@ void libelf_setsymtab(FAR const struct symtab_s *symtab, int nsymbols)
   libelf_registry_lock();
   g_libelf_symtab   = symtab;
   g_libelf_nsymbols = nsymbols;
+
+#ifdef CONFIG_LIBC_ELF_HASHED_EXPORTS
+  /* The index of the previous table is of no use any more */
+
+  lib_free(g_libelf_symhash);
+  g_libelf_symhash = NULL;
+#endif
+
+  libelf_registry_unlock();
+}
+
+/****************************************************************************
+ * Name: libelf_findexport
+ *
+ * Description:
+ *   Find a symbol exported by the base code.  If 'exports' is the kernel
+ *   symbol table, the symbol is looked up through its hash index, which is
+ *   built at the first call.  Any other table, or the kernel symbol table
+ *   if there is no memory for the index, is searched with
+ *   symtab_findbyname().
+ *
+ * Input Parameters:
+ *   exports  - The table of exported symbols
+ *   name     - The name of the symbol
+ *   nexports - The number of symbols in the exports table
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry, or NULL if the symbol is not
+ *   exported.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+libelf_findexport(FAR const struct symtab_s *exports,
+                  FAR const char *name, int nexports)
+{
+#ifdef CONFIG_LIBC_ELF_HASHED_EXPORTS
+  FAR const struct symtab_s *symbol = NULL;
+  uint32_t slot;
+  uint32_t ndx;
+
+  if (exports == NULL)
+    {
+      return NULL;
+    }
+
+  /* binfmt binds without holding the registry lock, so take it here to
+   * keep the index from being built twice or freed by
+   * libelf_setsymtab() while it is searched.  The lock is recursive, so
+   * the callers that already hold it are fine.
+   */
+
+  libelf_registry_lock();
+  if (exports != g_libelf_symtab || nexports != g_libelf_nsymbols ||
+      (g_libelf_symhash == NULL && libelf_buildhash() < 0))
+    {
+      libelf_registry_unlock();
+      return symtab_findbyname(exports, name, nexports);
+    }
+
+#ifdef CONFIG_SYMTAB_DECORATED
+  if (name[0] == '_')
+    {
+      name++;
+    }
+#endif
+
+  slot = libelf_hashname(name);
+  while ((ndx = g_libelf_symhash[slot & g_libelf_symmask]) != 0)
+    {
+      if (strcmp(exports[ndx - 1].sym_name, name) == 0)
+        {
+          symbol = &exports[ndx - 1];
+          break;
+        }
+
+      slot++;
+    }
+
   libelf_registry_unlock();
+  return symbol;
+#else
+  return symtab_findbyname(exports, name, nexports);
+#endif
 }
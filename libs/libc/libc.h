@@ -161,6 +161,18 @@
 #  define ARCH_LIBCFUN(x)  x
 #endif
 
+/* Word-at-a-time helpers of the string functions optimized for speed.
+ * LIBC_HASZERO(w) is non-zero if any byte of the word 'w' is zero.
+ */
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#  define LIBC_WORDSIZE    sizeof(uintptr_t)
+#  define LIBC_WORDMASK    (LIBC_WORDSIZE - 1)
+#  define LIBC_WORDONES    (UINTPTR_MAX / 0xff)
+#  define LIBC_WORDHIGHS   (LIBC_WORDONES << 7)
+#  define LIBC_HASZERO(w)  (((w) - LIBC_WORDONES) & ~(w) & LIBC_WORDHIGHS)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -81,6 +81,7 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
       if (!infmt)
         {
           len = 0;
+          prec = NULL;
           infmt = true;
           memset(fmtstr, 0, sizeof(fmtstr));
         }
@@ -88,6 +89,16 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
       var = (FAR void *)((char *)buf + offset);
       fmtstr[len++] = c;
 
+      if (c == '%' && len == 2)
+        {
+          /* "%%" is a literal percent sign */
+
+          lib_stream_putc(s, c);
+          ret++;
+          infmt = false;
+          continue;
+        }
+
       if (c == 'c' || c == 'd' || c == 'i' || c == 'u' ||
           c == 'o' || c == 'x' || c == 'X')
         {
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
@@ -54,6 +55,32 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 {
   FAR const unsigned char *p = (FAR const unsigned char *)s;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  uintptr_t mask = LIBC_WORDONES * (unsigned char)c;
+
+  while (n > 0 && ((uintptr_t)p & LIBC_WORDMASK) != 0)
+    {
+      if (*p == (unsigned char)c)
+        {
+          return (FAR void *)p;
+        }
+
+      p++;
+      n--;
+    }
+
+  /* Skip words without 'c'.  A word holds 'c' if its XOR with a word of
+   * all 'c' has a zero byte.
+   */
+
+  while (n >= LIBC_WORDSIZE &&
+         !LIBC_HASZERO(*(FAR const uintptr_t *)p ^ mask))
+    {
+      p += LIBC_WORDSIZE;
+      n -= LIBC_WORDSIZE;
+    }
+#endif
+
   while (n--)
     {
       if (*p == (unsigned char)c)
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
@@ -42,6 +43,36 @@ int memcmp(FAR const void *s1, FAR const void *s2, size_t n)
   FAR unsigned char *p1 = (FAR unsigned char *)s1;
   FAR unsigned char *p2 = (FAR unsigned char *)s2;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* Skip equal words if both pointers can be aligned.  The first
+   * difference is then located by the byte loop below.
+   */
+
+  if (n >= 2 * LIBC_WORDSIZE &&
+      (((uintptr_t)p1 ^ (uintptr_t)p2) & LIBC_WORDMASK) == 0)
+    {
+      while (((uintptr_t)p1 & LIBC_WORDMASK) != 0)
+        {
+          if (*p1 != *p2)
+            {
+              return *p1 < *p2 ? -1 : 1;
+            }
+
+          p1++;
+          p2++;
+          n--;
+        }
+
+      while (n >= LIBC_WORDSIZE &&
+             *(FAR const uintptr_t *)p1 == *(FAR const uintptr_t *)p2)
+        {
+          p1 += LIBC_WORDSIZE;
+          p2 += LIBC_WORDSIZE;
+          n  -= LIBC_WORDSIZE;
+        }
+    }
+#endif
+
   while (n-- > 0)
     {
       if (*p1 < *p2)
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "libc.h"
@@ -36,6 +37,33 @@
 
 #if !defined(CONFIG_LIBC_ARCH_STRLEN) && defined(LIBC_BUILD_STRLEN)
 #undef strlen /* See mm/README.txt */
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+nosanitize_address
+size_t strlen(FAR const char *s)
+{
+  FAR const char *sc = s;
+  FAR const uintptr_t *w;
+
+  while (((uintptr_t)sc & LIBC_WORDMASK) != 0)
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+
+      sc++;
+    }
+
+  /* An aligned word never crosses a page boundary, so reading the whole
+   * word that holds the terminator is safe.
+   */
+
+  for (w = (FAR const uintptr_t *)sc; !LIBC_HASZERO(*w); w++);
+
+  for (sc = (FAR const char *)w; *sc != '\0'; ++sc);
+  return sc - s;
+}
+#else
 size_t strlen(FAR const char *s)
 {
   FAR const char *sc;
@@ -43,3 +71,4 @@ size_t strlen(FAR const char *s)
   return sc - s;
 }
 #endif
+#endif
@@ -24,9 +24,27 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
 #include <nuttx/allsyms.h>
 #include <nuttx/symtab.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* g_allsyms[] is ordered by value unless it was generated ordered by name.
+ * The first and the last entries are boundaries, and the last one does not
+ * need to be in order on 64-bit targets.
+ */
+
+#if defined(CONFIG_ALLSYMS_INDEX) || !defined(CONFIG_SYMTAB_ORDEREDBYNAME)
+#  define ALLSYMS_ORDEREDBYVALUE 1
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -34,6 +52,120 @@
 extern const struct symtab_s g_allsyms[];
 extern const int             g_nallsyms;
 
+#ifdef CONFIG_ALLSYMS_INDEX
+/* The perfect hash of the names generated by tools/mkallsyms.py */
+
+extern const uint16_t        g_allsyms_hashdisp[];
+extern const uint32_t        g_allsyms_hashslot[];
+extern const int             g_nallsyms_hashdisp;
+extern const int             g_nallsyms_hashslot;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_ALLSYMS_INDEX
+/****************************************************************************
+ * Name: allsyms_hash
+ *
+ * Description:
+ *   32-bit FNV-1a hash of the name, with the seed folded into the offset
+ *   basis.  This must match symbol_hash() in tools/mkallsyms.py.
+ *
+ ****************************************************************************/
+
+static uint32_t allsyms_hash(FAR const char *name, uint32_t seed)
+{
+  uint32_t hash = 2166136261u ^ seed;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: allsyms_findbyhash
+ *
+ * Description:
+ *   Find the symbol with the matching name through the perfect hash.  The
+ *   name selects a seed, the seed selects the only slot the name can be in.
+ *
+ ****************************************************************************/
+
+static FAR const struct symtab_s *allsyms_findbyhash(FAR const char *name)
+{
+  FAR const struct symtab_s *symbol;
+  uint32_t disp;
+  uint32_t slot;
+
+  disp = g_allsyms_hashdisp[allsyms_hash(name, 0) % g_nallsyms_hashdisp];
+  slot = g_allsyms_hashslot[allsyms_hash(name, disp) % g_nallsyms_hashslot];
+
+  /* Empty slots refer to the leading boundary */
+
+  symbol = &g_allsyms[slot];
+  if (slot == 0 || slot >= g_nallsyms - 1 ||
+      strcmp(symbol->sym_name, name) != 0)
+    {
+      return NULL;
+    }
+
+  return symbol;
+}
+#endif
+
+#ifdef ALLSYMS_ORDEREDBYVALUE
+/****************************************************************************
+ * Name: allsyms_findbyaddr
+ *
+ * Description:
+ *   Binary search for the symbol with the largest value not greater than
+ *   'value'.  Of several symbols with that value, the first one is
+ *   returned, like a linear search would.
+ *
+ ****************************************************************************/
+
+static FAR const struct symtab_s *allsyms_findbyaddr(FAR void *value)
+{
+  int low  = 0;
+  int high = g_nallsyms - 1;
+  int mid;
+
+  /* Find the first entry above 'value' among g_allsyms[0 .. high - 1] */
+
+  while (low < high)
+    {
+      mid = (low + high) >> 1;
+      if (g_allsyms[mid].sym_value > value)
+        {
+          high = mid;
+        }
+      else
+        {
+          low = mid + 1;
+        }
+    }
+
+  if (low == 0)
+    {
+      return NULL;
+    }
+
+  while (low > 1 &&
+         g_allsyms[low - 2].sym_value == g_allsyms[low - 1].sym_value)
+    {
+      low--;
+    }
+
+  return &g_allsyms[low - 1];
+}
+#endif
+
 /****************************************************************************
  * Name: allsyms_lookup
  *
@@ -54,11 +186,19 @@ allsyms_lookup(FAR const char *name, FAR void *value,
 
   if (name)
     {
+#ifdef CONFIG_ALLSYMS_INDEX
+      symbol = allsyms_findbyhash(name);
+#else
       symbol = symtab_findbyname(g_allsyms, name, g_nallsyms);
+#endif
     }
   else if (value)
     {
+#ifdef ALLSYMS_ORDEREDBYVALUE
+      symbol = allsyms_findbyaddr(value);
+#else
       symbol = symtab_findbyvalue(g_allsyms, value, g_nallsyms);
+#endif
     }
 
   if (symbol && symbol != &g_allsyms[g_nallsyms - 1])
@@ -29,6 +29,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <debug.h>
 
 #include <nuttx/mm/iob.h>
@@ -137,6 +138,74 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Return a list of I/O buffers, linked by io_flink, to the free list (or
+ *   to the committed list if there are waiters).  This function is intended
+ *   only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_free_list(FAR struct iob_s *iob);
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Allocate up to 'count' I/O buffers from the cache of the current CPU.
+ *   Return the number of I/O buffers allocated.
+ *
+ ****************************************************************************/
+
+int iob_cache_alloc(FAR struct iob_s **iobs, int count, bool throttled);
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put a list of I/O buffers into the cache of the current CPU.  The I/O
+ *   buffers that the cache cannot take are returned; they must be freed
+ *   with iob_free_list().
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the I/O buffers in the caches of all CPUs to the free list.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void);
+
+/****************************************************************************
+ * Name: iob_cache_drain_local
+ *
+ * Description:
+ *   Return the I/O buffers in the cache of the current CPU to the free
+ *   list.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain_local(void);
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers in the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
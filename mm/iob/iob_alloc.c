@@ -142,6 +142,35 @@ static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
   return NULL;
 }
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/****************************************************************************
+ * Name: iob_cache_drain_miss
+ *
+ * Description:
+ *   Make cached IOBs available after a non-blocking allocation missed the
+ *   cache of this CPU.  An unthrottled miss means that the free list is
+ *   empty, so the caches of all CPUs are drained.  A throttled miss
+ *   usually just means that the free list is down to the throttle
+ *   reserve, and callers tend to retry it over and over, so only the
+ *   cache of this CPU is given back; the other CPUs keep theirs until
+ *   a throttled allocation actually has to wait.
+ *
+ ****************************************************************************/
+
+static void iob_cache_drain_miss(bool throttled)
+{
+#if CONFIG_IOB_THROTTLE > 0
+  if (throttled)
+    {
+      iob_cache_drain_local();
+      return;
+    }
+#endif
+
+  iob_cache_drain();
+}
+#endif
+
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -173,6 +202,15 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
    * we are waiting for I/O buffers to become free.
    */
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Try the cache of this CPU first */
+
+  if (iob_cache_alloc(&iob, 1, throttled) > 0)
+    {
+      return iob;
+    }
+#endif
+
   flags = spin_lock_irqsave(&g_iob_lock);
 
   /* Try to get an I/O buffer */
@@ -193,6 +231,18 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
       spin_unlock_irqrestore(&g_iob_lock, flags);
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+      /* Now that we are registered as a waiter, no more IOBs go into the
+       * caches.  Give the IOBs held by all CPUs back; iob_free_list()
+       * hands them to the waiters, possibly including us.  This is the
+       * only place where a throttled allocation drains the caches of the
+       * other CPUs, so it happens once per wait rather than on every
+       * retry of a failed iob_tryalloc().
+       */
+
+      iob_cache_drain();
+#endif
+
       if (timeout == UINT_MAX)
         {
           ret = nxsem_wait_uninterruptible(sem);
@@ -300,6 +350,15 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   FAR struct iob_s *iob;
   irqstate_t flags;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  if (iob_cache_alloc(&iob, 1, throttled) > 0)
+    {
+      return iob;
+    }
+
+  iob_cache_drain_miss(throttled);
+#endif
+
   /* We don't know what context we are called from so we use extreme measures
    * to protect the free list:  We disable interrupts very briefly.
    */
@@ -310,6 +369,51 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_alloc_batch
+ *
+ * Description:
+ *   Try to allocate 'count' I/O buffers at once without waiting.  The I/O
+ *   buffers are taken from the per-CPU cache first, then from the free
+ *   list under a single lock.
+ *
+ * Returned Value:
+ *   The number of I/O buffers returned in 'iobs', which may be less than
+ *   'count' if the pool runs out.
+ *
+ ****************************************************************************/
+
+int iob_alloc_batch(FAR struct iob_s **iobs, int count, bool throttled)
+{
+  irqstate_t flags;
+  int n = 0;
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  n = iob_cache_alloc(iobs, count, throttled);
+  if (n >= count)
+    {
+      return n;
+    }
+
+  iob_cache_drain_miss(throttled);
+#endif
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  while (n < count)
+    {
+      iobs[n] = iob_tryalloc_internal(throttled);
+      if (iobs[n] == NULL)
+        {
+          break;
+        }
+
+      n++;
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return n;
+}
+
 #ifdef CONFIG_IOB_ALLOC
 
 /****************************************************************************
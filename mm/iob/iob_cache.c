@@ -0,0 +1,403 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define IOB_NCACHES     CONFIG_SMP_NCPUS
+#else
+#  define IOB_NCACHES     1
+#endif
+
+/* The number of IOBs moved between a CPU cache and the global free list at
+ * once.
+ */
+
+#define IOB_CACHE_BATCH   ((CONFIG_IOB_PERCPU_CACHE + 1) / 2)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The IOBs cached for one CPU.  Only that CPU uses the cache, except when
+ * the caches are drained because the global free list ran empty, so the
+ * lock is normally uncontended.
+ */
+
+struct iob_cache_s
+{
+  spinlock_t lock;
+  FAR struct iob_s *head;          /* Cached IOBs, linked by io_flink */
+  int16_t count;                   /* Number of cached IOBs */
+  uint32_t nhit;                   /* Allocations served by the cache */
+  uint32_t nrefill;                /* Refills from the global free list */
+  uint32_t ndrain;                 /* Returns to the global free list */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct iob_cache_s g_iob_cache[IOB_NCACHES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_lock
+ *
+ * Description:
+ *   Lock the cache of the current CPU.  Should the task migrate before the
+ *   lock is taken, it just uses the cache of another CPU for this once,
+ *   which is harmless since the cache is locked.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_cache_s *iob_cache_lock(FAR irqstate_t *flags)
+{
+  FAR struct iob_cache_s *cache;
+
+  cache  = &g_iob_cache[this_cpu()];
+  *flags = spin_lock_irqsave(&cache->lock);
+  return cache;
+}
+
+/****************************************************************************
+ * Name: iob_cache_refill
+ *
+ * Description:
+ *   Move up to IOB_CACHE_BATCH IOBs from the global free list into the
+ *   cache, leaving the throttle reserve alone for throttled allocations.
+ *
+ ****************************************************************************/
+
+static void iob_cache_refill(FAR struct iob_cache_s *cache, bool throttled)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int16_t count;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  count = g_iob_count;
+#if CONFIG_IOB_THROTTLE > 0
+  if (throttled)
+    {
+      count -= CONFIG_IOB_THROTTLE;
+    }
+#endif
+
+  if (count > IOB_CACHE_BATCH)
+    {
+      count = IOB_CACHE_BATCH;
+    }
+
+  while (count-- > 0 && g_iob_freelist != NULL)
+    {
+      iob            = g_iob_freelist;
+      g_iob_freelist = iob->io_flink;
+      g_iob_count--;
+
+      iob->io_flink  = cache->head;
+      cache->head    = iob;
+      cache->count++;
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  cache->nrefill++;
+}
+
+/****************************************************************************
+ * Name: iob_cache_flush
+ *
+ * Description:
+ *   Return all IOBs of one cache to the global free list.
+ *
+ ****************************************************************************/
+
+static void iob_cache_flush(FAR struct iob_cache_s *cache)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  flags        = spin_lock_irqsave(&cache->lock);
+  iob          = cache->head;
+  cache->head  = NULL;
+  cache->count = 0;
+  if (iob != NULL)
+    {
+      cache->ndrain++;
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+
+  if (iob != NULL)
+    {
+      iob_free_list(iob);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Allocate up to 'count' IOBs from the cache of the current CPU,
+ *   refilling it from the global free list as necessary.
+ *
+ * Returned Value:
+ *   The number of IOBs returned in 'iobs'.
+ *
+ ****************************************************************************/
+
+int iob_cache_alloc(FAR struct iob_s **iobs, int count, bool throttled)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int n = 0;
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* The throttle reserve is only checked against the global free list,
+   * the cached IOBs do not count.
+   */
+
+  if (throttled && g_iob_count <= CONFIG_IOB_THROTTLE)
+    {
+      return 0;
+    }
+#endif
+
+  cache = iob_cache_lock(&flags);
+
+  while (n < count)
+    {
+      if (cache->head == NULL)
+        {
+          iob_cache_refill(cache, throttled);
+          if (cache->head == NULL)
+            {
+              break;
+            }
+        }
+      else
+        {
+          cache->nhit++;
+        }
+
+      iob         = cache->head;
+      cache->head = iob->io_flink;
+      cache->count--;
+
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+      iobs[n++]      = iob;
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+  return n;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put the IOBs of the list 'iob' (linked by io_flink) into the cache of
+ *   the current CPU.  When the cache is full, the IOBs that do not fit and
+ *   IOB_CACHE_BATCH of the cached ones are returned to the caller, which
+ *   must give them back to the global free list with iob_free_list().
+ *   Nothing is cached while some task is waiting for an IOB.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int i;
+
+  cache = iob_cache_lock(&flags);
+
+  /* Waiters are served from the committed list, so the IOBs must not be
+   * cached if there are any.  iob_allocwait() registers as a waiter
+   * before it drains the caches, so checking under the cache lock is
+   * enough: either the waiter is seen here or the drain finds the IOBs
+   * in the cache.
+   */
+
+  if (g_iob_count < 0
+#if CONFIG_IOB_THROTTLE > 0
+      || g_throttle_wait > 0
+#endif
+     )
+    {
+      spin_unlock_irqrestore(&cache->lock, flags);
+      return iob;
+    }
+
+  while (iob != NULL && cache->count < CONFIG_IOB_PERCPU_CACHE)
+    {
+      next          = iob->io_flink;
+      iob->io_flink = cache->head;
+      cache->head   = iob;
+      cache->count++;
+      iob           = next;
+    }
+
+  if (iob != NULL)
+    {
+      /* Hand a batch of cached IOBs back together with the rest */
+
+      for (i = 0; i < IOB_CACHE_BATCH && cache->head != NULL; i++)
+        {
+          next           = cache->head;
+          cache->head    = next->io_flink;
+          cache->count--;
+          next->io_flink = iob;
+          iob            = next;
+        }
+
+      cache->ndrain++;
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the IOBs in the caches of all CPUs to the global free list.
+ *   This is done when the global free list is empty, so that the IOBs
+ *   held by other CPUs become available.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void)
+{
+  int i;
+
+  for (i = 0; i < IOB_NCACHES; i++)
+    {
+      iob_cache_flush(&g_iob_cache[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: iob_cache_drain_local
+ *
+ * Description:
+ *   Return the IOBs in the cache of the current CPU to the global free
+ *   list, leaving the caches of the other CPUs alone.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain_local(void)
+{
+  iob_cache_flush(&g_iob_cache[this_cpu()]);
+}
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of IOBs in the caches of all CPUs.
+ *
+ ****************************************************************************/
+
+int iob_cache_navail(void)
+{
+  int navail = 0;
+  int i;
+
+  for (i = 0; i < IOB_NCACHES; i++)
+    {
+      navail += g_iob_cache[i].count;
+    }
+
+  return navail;
+}
+
+/****************************************************************************
+ * Name: iob_getcachestats
+ *
+ * Description:
+ *   Return the statistics of the IOB cache of one CPU.
+ *
+ * Input Parameters:
+ *   cpu   - The CPU whose cache is inquired
+ *   stats - Location to return the statistics
+ *
+ * Returned Value:
+ *   OK on success, -EINVAL if there is no such CPU.
+ *
+ ****************************************************************************/
+
+int iob_getcachestats(int cpu, FAR struct iob_cachestats_s *stats)
+{
+  FAR struct iob_cache_s *cache;
+
+  if (cpu < 0 || cpu >= IOB_NCACHES)
+    {
+      return -EINVAL;
+    }
+
+  cache = &g_iob_cache[cpu];
+
+  stats->ncached = cache->count;
+  stats->nhit    = cache->nhit;
+  stats->nrefill = cache->nrefill;
+  stats->ndrain  = cache->ndrain;
+  return OK;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE > 0 */
@@ -64,33 +64,61 @@
 #define IOB_MASK      (IOB_DIVIDER - 1)
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: iob_free
+ * Name: iob_free_notify
  *
  * Description:
- *   Free the I/O buffer at the head of a buffer chain returning it to the
- *   free list.  The link to  the next I/O buffer in the chain is return.
+ *   Signal the threads waiting for an IOB notification, if enough IOBs
+ *   are available.
  *
  ****************************************************************************/
 
-FAR struct iob_s *iob_free(FAR struct iob_s *iob)
-{
-  FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
 #ifdef CONFIG_IOB_NOTIFIER
+static void iob_free_notify(void)
+{
   int16_t navail;
+
+  /* Check if the IOB was claimed by a thread that is blocked waiting
+   * for an IOB.
+   */
+
+  navail = iob_navail(false);
+  if (navail > 0 && (navail & IOB_MASK) == 0)
+    {
+      /* Signal any threads that have requested a signal notification
+       * when an IOB becomes available.
+       */
+
+      iob_notifier_signal();
+    }
+}
+#else
+#  define iob_free_notify()
 #endif
 
+/****************************************************************************
+ * Name: iob_free_prepare
+ *
+ * Description:
+ *   Copy the data that only exists in the head of a I/O buffer chain into
+ *   the next entry and release a dynamically allocated I/O buffer.
+ *
+ * Returned Value:
+ *   true if the I/O buffer was released, false if it still has to be
+ *   returned to the pool.
+ *
+ ****************************************************************************/
+
+static bool iob_free_prepare(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next = iob->io_flink;
+
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
 
-  /* Copy the data that only exists in the head of a I/O buffer chain into
-   * the next entry.
-   */
-
   if (next != NULL)
     {
       /* Copy and decrement the total packet length, being careful to
@@ -122,11 +150,59 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
     {
       iob->io_free(iob->io_data);
       kmm_free(iob);
-      return next;
+      return true;
     }
 #endif
 
-  /* Free the I/O buffer by adding it to the head of the free or the
+  return false;
+}
+
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return a list of I/O buffers, linked by io_flink, to the pool.  The
+ *   per-CPU cache is used unless some task is waiting for an IOB.
+ *
+ ****************************************************************************/
+
+static void iob_free_pool(FAR struct iob_s *iob)
+{
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  iob = iob_cache_free(iob);
+#endif
+
+  if (iob != NULL)
+    {
+      iob_free_list(iob);
+    }
+
+  iob_free_notify();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_free_list
+ *
+ * Description:
+ *   Return a list of I/O buffers, linked by io_flink, to the free list or
+ *   to the committed list if there are waiters.
+ *
+ ****************************************************************************/
+
+void iob_free_list(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int npost = 0;
+#if CONFIG_IOB_THROTTLE > 0
+  int nthrottle = 0;
+#endif
+
+  /* Free the I/O buffers by adding them to the head of the free or the
    * committed list. We don't know what context we are called from so
    * we use extreme measures to protect the free list:  We disable
    * interrupts very briefly.
@@ -134,58 +210,115 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 
   flags = spin_lock_irqsave(&g_iob_lock);
 
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()). This is true for both throttled and non-throttled
-   * cases.
-   */
+  for (; iob != NULL; iob = next)
+    {
+      next = iob->io_flink;
+
+      /* Which list?  If there is a task waiting for an IOB, then put
+       * the IOB on either the free list or on the committed list where
+       * it is reserved for that allocation (and not available to
+       * iob_tryalloc()). This is true for both throttled and non-throttled
+       * cases.
+       */
+
+      if (g_iob_count < 0)
+        {
+          g_iob_count++;
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+          npost++;
+        }
+#if CONFIG_IOB_THROTTLE > 0
+      else if (g_throttle_wait > 0 && g_iob_count >= CONFIG_IOB_THROTTLE)
+        {
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+          g_throttle_wait--;
+          nthrottle++;
+        }
+#endif
+      else
+        {
+          g_iob_count++;
+          iob->io_flink   = g_iob_freelist;
+          g_iob_freelist  = iob;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
 
-  if (g_iob_count < 0)
+  /* Wake up the waiters after the lock has been released */
+
+  while (npost-- > 0)
     {
-      g_iob_count++;
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
       nxsem_post(&g_iob_sem);
     }
+
 #if CONFIG_IOB_THROTTLE > 0
-  else if (g_throttle_wait > 0 && g_iob_count >= CONFIG_IOB_THROTTLE)
+  while (nthrottle-- > 0)
     {
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      g_throttle_wait--;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
       nxsem_post(&g_throttle_sem);
     }
 #endif
-  else
-    {
-      g_iob_count++;
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-    }
 
   DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+}
 
-#ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
-   */
+/****************************************************************************
+ * Name: iob_free
+ *
+ * Description:
+ *   Free the I/O buffer at the head of a buffer chain returning it to the
+ *   free list.  The link to  the next I/O buffer in the chain is return.
+ *
+ ****************************************************************************/
 
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
-    {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
+FAR struct iob_s *iob_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next = iob->io_flink;
 
-      iob_notifier_signal();
+  if (!iob_free_prepare(iob))
+    {
+      iob->io_flink = NULL;
+      iob_free_pool(iob);
     }
-#endif
 
   /* And return the I/O buffer after the one that was freed */
 
   return next;
 }
+
+/****************************************************************************
+ * Name: iob_free_batch
+ *
+ * Description:
+ *   Free 'count' I/O buffer chains at once.  The I/O buffers are returned
+ *   to the pool together, taking the locks only once.
+ *
+ ****************************************************************************/
+
+void iob_free_batch(FAR struct iob_s **iobs, int count)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *iob;
+  FAR struct iob_s *next;
+  int i;
+
+  for (i = 0; i < count; i++)
+    {
+      for (iob = iobs[i]; iob != NULL; iob = next)
+        {
+          next = iob->io_flink;
+          if (!iob_free_prepare(iob))
+            {
+              iob->io_flink = head;
+              head          = iob;
+            }
+        }
+    }
+
+  if (head != NULL)
+    {
+      iob_free_pool(head);
+    }
+}
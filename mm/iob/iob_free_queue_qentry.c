@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 #include <assert.h>
+#include <errno.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
@@ -43,12 +44,16 @@
  * Name: iob_free_queue_qentry
  *
  * Description:
- *   Free an iob entire queue of I/O buffer chains.
+ *   Remove the I/O buffer chain 'iob' from a queue and free it.
+ *
+ * Returned Value:
+ *   OK if the chain was found and freed; -ENOENT if it is not in the
+ *   queue.
  *
  ****************************************************************************/
 
-void iob_free_queue_qentry(FAR struct iob_s *iob,
-                           FAR struct iob_queue_s *iobq)
+int iob_free_queue_qentry(FAR struct iob_s *iob,
+                          FAR struct iob_queue_s *iobq)
 {
   FAR struct iob_qentry_s *prev = NULL;
   FAR struct iob_qentry_s *qentry;
@@ -81,10 +86,11 @@ void iob_free_queue_qentry(FAR struct iob_s *iob,
           /* Free the I/O chain */
 
           iob_free_chain(iob);
-
-          break;
+          return OK;
         }
     }
+
+  return -ENOENT;
 }
 
 #endif /* CONFIG_IOB_NCHAINS > 0 */
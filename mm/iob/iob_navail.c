@@ -65,6 +65,12 @@ int iob_navail(bool throttled)
       ret = 0;
     }
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* The IOBs held in the per-CPU caches are available too */
+
+  ret += iob_cache_navail();
+#endif
+
 #else
   ret = 0;
 #endif
@@ -67,6 +67,10 @@ void iob_getstats(FAR struct iob_stats_s *stats)
       stats->nwait = 0;
     }
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  stats->nfree += iob_cache_navail();
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   stats->nthrottle = (g_iob_count - CONFIG_IOB_THROTTLE);
   if (stats->nthrottle < 0)
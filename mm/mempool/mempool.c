@@ -24,6 +24,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+
 #include <assert.h>
 #include <execinfo.h>
 #include <stdbool.h>
@@ -40,6 +42,14 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+/* The number of blocks moved between a per-CPU cache and its pool at once */
+
+#  define MEMPOOL_CACHE_BATCH ((CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE + 1) / 2)
+
+#  define MEMPOOL_CACHE_USABLE(pool) ((pool)->cache != NULL && !(pool)->wait)
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 #define MEMPOOL_MAGIC_FREE  0xAAAAAAAA
 #define MEMPOOL_MAGIC_ALLOC 0x55555555
@@ -98,6 +108,167 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+
+/****************************************************************************
+ * Name: mempool_cache_allocate
+ *
+ * Description:
+ *   Take a free block from the cache of this CPU.  An empty cache is
+ *   refilled with up to MEMPOOL_CACHE_BATCH blocks from the free queue of
+ *   the pool, taking the pool lock only once.  NULL is returned if the
+ *   free queue is empty too; then the caller falls back to the normal path
+ *   that may expand the pool.
+ *
+ ****************************************************************************/
+
+static FAR sq_entry_t *mempool_cache_allocate(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_cache_s *cache;
+  FAR sq_entry_t *blk = NULL;
+  irqstate_t flags;
+
+  /* With the local interrupts disabled, nothing else can run on this CPU
+   * and the task cannot migrate to another one.
+   */
+
+  flags = up_irq_save();
+  cache = &pool->cache[this_cpu()];
+  if (cache->count == 0)
+    {
+      irqstate_t lflags;
+      size_t count = 0;
+
+      cache->nmiss++;
+
+      lflags = spin_lock_irqsave(&pool->lock);
+      while (count < MEMPOOL_CACHE_BATCH &&
+             (blk = mempool_remove_queue(pool, &pool->queue)) != NULL)
+        {
+          cache->blks[count++] = blk;
+        }
+
+      pool->nalloc += count;
+      spin_unlock_irqrestore(&pool->lock, lflags);
+
+      if (count == 0)
+        {
+          up_irq_restore(flags);
+          return NULL;
+        }
+
+      cache->count = count;
+      cache->nrefill++;
+    }
+  else
+    {
+      cache->nhit++;
+    }
+
+  blk = cache->blks[--cache->count];
+  up_irq_restore(flags);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_release
+ *
+ * Description:
+ *   Put a released block into the cache of this CPU.  A full cache first
+ *   gives its MEMPOOL_CACHE_BATCH oldest blocks back to the pool, taking
+ *   the pool lock only once.  Blocks of the interrupt mempool are never
+ *   cached.
+ *
+ * Returned Value:
+ *   True if the block was cached; false if the caller has to release it to
+ *   the pool itself.
+ *
+ ****************************************************************************/
+
+static bool mempool_cache_release(FAR struct mempool_s *pool,
+                                  FAR void *blk)
+{
+  size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  FAR struct mempool_cache_s *cache;
+  irqstate_t flags;
+#if CONFIG_MM_BACKTRACE >= 0
+  FAR struct mempool_backtrace_s *buf =
+    (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
+#endif
+
+  if (pool->interruptsize > blocksize &&
+      (FAR char *)blk >= pool->ibase &&
+      (FAR char *)blk < pool->ibase + pool->interruptsize - blocksize)
+    {
+      return false;
+    }
+
+#if CONFIG_MM_BACKTRACE >= 0
+  /* Check double free or out of out of bounds */
+
+  DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
+  buf->magic = MEMPOOL_MAGIC_FREE;
+#endif
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(blk, MM_FREE_MAGIC, pool->blocksize);
+#endif
+
+  kasan_poison(blk, pool->blocksize);
+
+  flags = up_irq_save();
+  cache = &pool->cache[this_cpu()];
+  if (cache->count == CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE)
+    {
+      irqstate_t lflags;
+      size_t i;
+
+      lflags = spin_lock_irqsave(&pool->lock);
+      for (i = 0; i < MEMPOOL_CACHE_BATCH; i++)
+        {
+          sq_addlast(cache->blks[i], &pool->queue);
+        }
+
+      pool->nalloc -= MEMPOOL_CACHE_BATCH;
+      spin_unlock_irqrestore(&pool->lock, lflags);
+
+      cache->count -= MEMPOOL_CACHE_BATCH;
+      memmove(cache->blks, cache->blks + MEMPOOL_CACHE_BATCH,
+              cache->count * sizeof(FAR void *));
+      cache->ndrain++;
+    }
+
+  cache->blks[cache->count++] = blk;
+  up_irq_restore(flags);
+  return true;
+}
+
+/****************************************************************************
+ * Name: mempool_cache_count
+ *
+ * Description:
+ *   Return the number of free blocks held by the per-CPU caches.  This is
+ *   only a snapshot while other CPUs use the pool.
+ *
+ ****************************************************************************/
+
+static size_t mempool_cache_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int cpu;
+
+  if (pool->cache != NULL)
+    {
+      for (cpu = 0; cpu < MEMPOOL_CACHE_NCPUS; cpu++)
+        {
+          count += pool->cache[cpu].count;
+        }
+    }
+
+  return count;
+}
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -344,6 +515,17 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+  if (MEMPOOL_CACHE_USABLE(pool))
+    {
+      blk = mempool_cache_allocate(pool);
+      if (blk != NULL)
+        {
+          goto out;
+        }
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(pool, &pool->queue);
@@ -398,6 +580,9 @@ retry:
   pool->nalloc++;
   spin_unlock_irqrestore(&pool->lock, flags);
 
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+out:
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   mempool_add_backtrace(pool, (FAR struct mempool_backtrace_s *)
                               ((FAR char *)blk + pool->blocksize));
@@ -424,12 +609,22 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  irqstate_t flags;
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
+#endif
+
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+  if (MEMPOOL_CACHE_USABLE(pool) && mempool_cache_release(pool, blk))
+    {
+      return;
+    }
+#endif
 
+  flags = spin_lock_irqsave(&pool->lock);
+#if CONFIG_MM_BACKTRACE >= 0
   /* Check double free or out of out of bounds */
 
   DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
@@ -502,6 +697,37 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
   info->arena = sq_count(&pool->equeue) * sizeof(sq_entry_t) +
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
   spin_unlock_irqrestore(&pool->lock, flags);
+
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+  /* The cached blocks are free although the pool counts them as used */
+
+  info->ncached = 0;
+  info->nhit = 0;
+  info->nmiss = 0;
+  info->nrefill = 0;
+  info->ndrain = 0;
+
+  if (pool->cache != NULL)
+    {
+      int cpu;
+
+      for (cpu = 0; cpu < MEMPOOL_CACHE_NCPUS; cpu++)
+        {
+          FAR struct mempool_cache_s *cache = &pool->cache[cpu];
+
+          info->ncached += cache->count;
+          info->nhit += cache->nhit;
+          info->nmiss += cache->nmiss;
+          info->nrefill += cache->nrefill;
+          info->ndrain += cache->ndrain;
+        }
+
+      info->ncached = MIN(info->ncached, info->aordblks);
+      info->aordblks -= info->ncached;
+      info->ordblks += info->ncached;
+    }
+#endif
+
   info->sizeblks = blocksize;
   if (pool->wait && pool->expandsize == 0)
     {
@@ -539,13 +765,21 @@ mempool_info_task(FAR struct mempool_s *pool,
                      sq_count(&pool->iqueue);
 
       spin_unlock_irqrestore(&pool->lock, flags);
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+      count += mempool_cache_count(pool);
+#endif
       info.aordblks += count;
       info.uordblks += count * blocksize;
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t count = pool->nalloc;
+
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+      count -= MIN(mempool_cache_count(pool), count);
+#endif
+      info.aordblks += count;
+      info.uordblks += count * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -615,6 +849,26 @@ int mempool_deinit(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   size_t count = 0;
 
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+  /* Give the cached blocks back to the pool first */
+
+  if (pool->cache != NULL)
+    {
+      int cpu;
+
+      for (cpu = 0; cpu < MEMPOOL_CACHE_NCPUS; cpu++)
+        {
+          FAR struct mempool_cache_s *cache = &pool->cache[cpu];
+
+          while (cache->count > 0)
+            {
+              sq_addlast(cache->blks[--cache->count], &pool->queue);
+              pool->nalloc--;
+            }
+        }
+    }
+#endif
+
   if (pool->nalloc != 0)
     {
       return -EBUSY;
@@ -403,6 +403,9 @@ mempool_multiple_init(FAR const char *name,
 {
   FAR struct mempool_multiple_s *mpool;
   FAR struct mempool_s *pools;
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+  FAR struct mempool_cache_s *caches;
+#endif
   size_t maxpoolszie;
   size_t minpoolsize;
   int ret;
@@ -430,7 +433,12 @@ mempool_multiple_init(FAR const char *name,
 
   mpool = alloc(arg, sizeof(uintptr_t),
                 sizeof(struct mempool_multiple_s) +
-                npools * sizeof(struct mempool_s));
+                npools * sizeof(struct mempool_s)
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+                + npools * MEMPOOL_CACHE_NCPUS *
+                  sizeof(struct mempool_cache_s)
+#endif
+                );
 
   if (mpool == NULL)
     {
@@ -439,6 +447,11 @@ mempool_multiple_init(FAR const char *name,
 
   pools = (FAR struct mempool_s *)
           ((uintptr_t)mpool + sizeof(struct mempool_multiple_s));
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+  caches = (FAR struct mempool_cache_s *)(pools + npools);
+  memset(caches, 0,
+         npools * MEMPOOL_CACHE_NCPUS * sizeof(struct mempool_cache_s));
+#endif
 
   mpool->alloc_size = alloc_size;
   mpool->expandsize = expandsize;
@@ -463,6 +476,10 @@ mempool_multiple_init(FAR const char *name,
       pools[i].alloc = mempool_multiple_alloc_callback;
       pools[i].free = mempool_multiple_free_callback;
       pools[i].check = mempool_multiple_check;
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+      pools[i].wait = false;
+      pools[i].cache = caches + i * MEMPOOL_CACHE_NCPUS;
+#endif
 
       ret = mempool_init(pools + i, name);
       if (ret < 0)
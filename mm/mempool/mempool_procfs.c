@@ -42,7 +42,11 @@
  * to handle the longest line generated by this logic.
  */
 
-#define MEMPOOLINFO_LINELEN 80
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+#  define MEMPOOLINFO_LINELEN 128
+#else
+#  define MEMPOOLINFO_LINELEN 80
+#endif
 
 /****************************************************************************
  * Private Types
@@ -142,9 +146,18 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
   offset    = filep->f_pos;
   procfile  = filep->f_priv;
   linesize  = procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
-                              "%13s%11s%9s%9s%9s%9s%9s\n", "", "total",
+                              "%13s%11s%9s%9s%9s%9s%9s"
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+                              "%9s%9s%9s%9s%9s"
+#endif
+                              "\n", "", "total",
                               "bsize", "nused", "nfree", "nifree",
-                              "nwaiter");
+                              "nwaiter"
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+                              , "ncached", "nhit", "nmiss", "nrefill",
+                              "ndrain"
+#endif
+                              );
 
   copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
                             &offset);
@@ -163,11 +176,21 @@ static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
 
           mempool_info(pool, &minfo);
           linesize   = procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
-                                       "%12s:%11lu%9lu%9lu%9lu%9lu%9lu\n",
+                                       "%12s:%11lu%9lu%9lu%9lu%9lu%9lu"
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+                                       "%9lu%9lu%9lu%9lu%9lu"
+#endif
+                                       "\n",
                                        entry->name, minfo.arena,
                                        minfo.sizeblks, minfo.aordblks,
                                        minfo.ordblks, minfo.iordblks,
-                                       minfo.nwaiter);
+                                       minfo.nwaiter
+#if CONFIG_MM_HEAP_MEMPOOL_CACHE_SIZE > 0
+                                       , minfo.ncached, minfo.nhit,
+                                       minfo.nmiss, minfo.nrefill,
+                                       minfo.ndrain
+#endif
+                                       );
           copysize   = procfs_memcpy(procfile->line, linesize, buffer,
                                      buflen, &offset);
           totalsize += copysize;
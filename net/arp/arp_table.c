@@ -73,6 +73,16 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+#if (CONFIG_NET_ARPTAB_HASHSIZE & (CONFIG_NET_ARPTAB_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_ARPTAB_HASHSIZE must be a power of two
+#endif
+
+/* Fold all four bytes of the IPv4 address into the bucket index */
+
+#define ARP_HASH(ipaddr) \
+  (((ipaddr) ^ ((ipaddr) >> 8) ^ ((ipaddr) >> 16) ^ ((ipaddr) >> 24)) & \
+   (CONFIG_NET_ARPTAB_HASHSIZE - 1))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -91,6 +101,28 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+/* The entries in use, chained by the hash of their IP address */
+
+static FAR struct arp_entry_s *g_arphash[CONFIG_NET_ARPTAB_HASHSIZE];
+
+/* The entries in use, least recently used last */
+
+static struct list_node g_arplru = LIST_INITIAL_VALUE(g_arplru);
+
+/* Deleted entries and the number of entries that were ever used.  Entries
+ * are only recycled from the LRU list when both are exhausted.
+ */
+
+static FAR struct arp_entry_s *g_arpfree;
+static unsigned int g_arpnused;
+
+/* The entry found by the last lookup.  Outgoing packets tend to come in
+ * bursts to the same destination, so this saves the hash lookup for most
+ * of them.
+ */
+
+static FAR struct arp_entry_s *g_arplast;
+
 static const struct ether_addr g_zero_ethaddr =
 {
   {
@@ -149,32 +181,110 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_hash_find
+ *
+ * Description:
+ *   Find the ARP entry in use for this IP address and device, regardless
+ *   of its age.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_hash_find(in_addr_t ipaddr,
+                                             FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+
+  for (tabptr = g_arphash[ARP_HASH(ipaddr)];
+       tabptr != NULL;
+       tabptr = tabptr->at_hnext)
+    {
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          break;
+        }
+    }
+
+  return tabptr;
+}
+
+/****************************************************************************
+ * Name: arp_hash_remove
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Remove an ARP entry in use from its hash chain and from the LRU list.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static void arp_hash_remove(FAR struct arp_entry_s *tabptr)
 {
-  if (e1->at_ipaddr == 0)
+  FAR struct arp_entry_s **pprev;
+
+  pprev = &g_arphash[ARP_HASH(tabptr->at_ipaddr)];
+  while (*pprev != tabptr)
+    {
+      DEBUGASSERT(*pprev != NULL);
+      pprev = &(*pprev)->at_hnext;
+    }
+
+  *pprev = tabptr->at_hnext;
+  list_delete(&tabptr->at_node);
+
+  if (g_arplast == tabptr)
     {
-      return e1;
+      g_arplast = NULL;
     }
-  else if (e2->at_ipaddr == 0)
+}
+
+/****************************************************************************
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Get an ARP entry for a new mapping: a deleted entry, an entry that was
+ *   never used or, when the table is full, the least recently used entry.
+ *   A recycled entry is removed from the table but keeps its content, so
+ *   at_ipaddr is non-zero in that case.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_alloc(void)
+{
+  FAR struct arp_entry_s *tabptr;
+
+  if (g_arpfree != NULL)
     {
-      return e2;
+      tabptr    = g_arpfree;
+      g_arpfree = tabptr->at_hnext;
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+  else if (g_arpnused < CONFIG_NET_ARPTAB_SIZE)
     {
-      return e1;
+      tabptr = &g_arptable[g_arpnused++];
     }
   else
     {
-      return e2;
+      tabptr = list_last_entry(&g_arplru, struct arp_entry_s, at_node);
+      arp_hash_remove(tabptr);
     }
+
+  return tabptr;
+}
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Remove an ARP entry in use from the table and put it on the free list.
+ *
+ ****************************************************************************/
+
+static void arp_release(FAR struct arp_entry_s *tabptr)
+{
+  arp_hash_remove(tabptr);
+
+  tabptr->at_ipaddr = 0;
+  tabptr->at_dev    = NULL;
+  tabptr->at_hnext  = g_arpfree;
+  g_arpfree         = tabptr;
 }
 
 /****************************************************************************
@@ -196,25 +306,36 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
-  FAR struct arp_entry_s *tabptr;
-  int i;
+  FAR struct arp_entry_s *tabptr = g_arplast;
 
-  /* Check if the IPv4 address is already in the ARP table. */
+  /* Check the entry of the last lookup first, then the hash chain. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  if (tabptr == NULL || tabptr->at_dev != dev ||
+      !net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
+      tabptr = arp_hash_find(ipaddr, dev);
+      if (tabptr == NULL)
         {
-          return tabptr;
+          return NULL;
         }
+
+      g_arplast = tabptr;
     }
 
-  /* Not found */
+  /* Make it the most recently used entry */
+
+  if (!list_is_head(&g_arplru, &tabptr->at_node))
+    {
+      list_delete(&tabptr->at_node);
+      list_add_head(&g_arplru, &tabptr->at_node);
+    }
+
+  if (clock_systime_ticks() - tabptr->at_time > ARP_MAXAGE_TICK)
+    {
+      return NULL;
+    }
 
-  return NULL;
+  return tabptr;
 }
 
 /****************************************************************************
@@ -275,43 +396,27 @@ static void arp_get_arpreq(FAR struct arpreq *output,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
-  bool found = false;
   bool new_entry;
 #endif
-  int i;
+  bool found;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping is inserted in a free or the least recently used
+   * entry of the ARP table.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_hash_find(ipaddr, dev);
+  found  = tabptr != NULL;
+  if (found)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
-#ifdef CONFIG_NETLINK_ROUTE
-          found = true;
-#endif
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
+      list_delete(&tabptr->at_node);
+    }
+  else
+    {
+      tabptr = arp_alloc();
     }
 
   if (ethaddr == NULL)
@@ -343,6 +448,14 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
   tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
 
+  if (!found)
+    {
+      tabptr->at_hnext = g_arphash[ARP_HASH(ipaddr)];
+      g_arphash[ARP_HASH(ipaddr)] = tabptr;
+    }
+
+  list_add_head(&g_arplru, &tabptr->at_node);
+
   /* Notify the new entry */
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -495,9 +608,9 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
       netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
 #endif
 
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Remove it and set the IP address to zero to "delete" it */
 
-      tabptr->at_ipaddr = 0;
+      arp_release(tabptr);
       return OK;
     }
 
@@ -524,9 +637,10 @@ void arp_cleanup(FAR struct net_driver_s *dev)
 
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      if (dev == g_arptable[i].at_dev)
+      if (dev == g_arptable[i].at_dev &&
+          list_in_list(&g_arptable[i].at_node))
         {
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          arp_release(&g_arptable[i]);
         }
     }
 }
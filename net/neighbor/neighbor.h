@@ -31,6 +31,7 @@
 
 #include <net/ethernet.h>
 
+#include <nuttx/list.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
@@ -38,6 +39,38 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_IPv6_NCONF_HASHSIZE & \
+     (CONFIG_NET_IPv6_NCONF_HASHSIZE - 1)) != 0
+#  error CONFIG_NET_IPv6_NCONF_HASHSIZE must be a power of two
+#endif
+
+/* The lookup state of a Neighbor Table entry and the entry of a lookup
+ * state.
+ */
+
+#define NEIGHBOR_LINK(n)  (&g_neighbor_links[(n) - g_neighbors])
+#define NEIGHBOR_ENTRY(l) (&g_neighbors[(l) - g_neighbor_links])
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The lookup state of one Neighbor Table entry.  This is kept apart from
+ * struct neighbor_entry_s because that structure is also returned to user
+ * space by neighbor_snapshot().  An entry is in use if it is in the LRU
+ * list.
+ */
+
+struct neighbor_link_s
+{
+  struct list_node nl_node;                /* LRU list, most recent first */
+  FAR struct neighbor_entry_s *nl_hnext;   /* Next in the hash chain */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -48,6 +81,63 @@
 
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The lookup state of the Neighbor Table entries: the entries in use are
+ * chained by the hash of their IPv6 address and kept in LRU order.
+ * g_neighbor_last is the entry found by the last lookup, which is checked
+ * first since outgoing packets tend to come in bursts to one destination.
+ */
+
+extern struct neighbor_link_s
+g_neighbor_links[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern FAR struct neighbor_entry_s *
+g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+extern struct list_node g_neighbor_lru;
+extern FAR struct neighbor_entry_s *g_neighbor_last;
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash bucket of an IPv6 address.
+ *
+ ****************************************************************************/
+
+static inline unsigned int neighbor_hash(FAR const uint16_t *ipaddr)
+{
+  uint16_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash ^= ipaddr[i];
+    }
+
+  return (hash ^ (hash >> 8)) & (CONFIG_NET_IPv6_NCONF_HASHSIZE - 1);
+}
+
+/****************************************************************************
+ * Name: neighbor_touch
+ *
+ * Description:
+ *   Make a Neighbor Table entry in use the most recently used one.
+ *
+ ****************************************************************************/
+
+static inline void neighbor_touch(FAR struct neighbor_entry_s *neighbor)
+{
+  FAR struct list_node *node = &NEIGHBOR_LINK(neighbor)->nl_node;
+
+  if (!list_is_head(&g_neighbor_lru, node))
+    {
+      list_delete(node);
+      list_add_head(&g_neighbor_lru, node);
+    }
+}
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
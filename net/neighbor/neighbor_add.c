@@ -41,6 +41,61 @@
 #include "netlink/netlink.h"
 #include "neighbor/neighbor.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The number of Neighbor Table entries that were ever used */
+
+static unsigned int g_neighbor_nused;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Get an entry for a new mapping: an entry that was never used or, when
+ *   the table is full, the least recently used entry.  A recycled entry is
+ *   removed from the lookup state but keeps its content.
+ *
+ ****************************************************************************/
+
+static FAR struct neighbor_entry_s *neighbor_alloc(void)
+{
+  FAR struct neighbor_entry_s **pprev;
+  FAR struct neighbor_entry_s *neighbor;
+  FAR struct neighbor_link_s *link;
+
+  if (g_neighbor_nused < CONFIG_NET_IPv6_NCONF_ENTRIES)
+    {
+      return &g_neighbors[g_neighbor_nused++];
+    }
+
+  link     = list_last_entry(&g_neighbor_lru, struct neighbor_link_s,
+                             nl_node);
+  neighbor = NEIGHBOR_ENTRY(link);
+
+  pprev = &g_neighbor_hash[neighbor_hash(neighbor->ne_ipaddr)];
+  while (*pprev != neighbor)
+    {
+      DEBUGASSERT(*pprev != NULL);
+      pprev = &NEIGHBOR_LINK(*pprev)->nl_hnext;
+    }
+
+  *pprev = link->nl_hnext;
+  list_delete(&link->nl_node);
+
+  if (g_neighbor_last == neighbor)
+    {
+      g_neighbor_last = NULL;
+    }
+
+  return neighbor;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,78 +120,84 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s *neighbor;
+  FAR struct neighbor_link_s *link;
+  unsigned int hash;
   uint8_t lltype;
-  clock_t oldest_time;
-  int     oldest_ndx;
   bool    found = false;
   bool    new_entry;
-  int     i;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
+  /* Find the matching entry, else an unused entry or the least recently
+   * used entry.  An unused entry has ne_time == 0.
    */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
+  hash   = neighbor_hash(ipaddr);
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = g_neighbor_hash[hash];
+       neighbor != NULL;
+       neighbor = NEIGHBOR_LINK(neighbor)->nl_hnext)
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      if (neighbor->ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
           found = true;
           break;
         }
+    }
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
-        {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
-        }
+  if (!found)
+    {
+      neighbor = neighbor_alloc();
     }
 
   /* When overwite old entry, need to notify RTM_DELNEIGH */
 
-  if (!found && g_neighbors[oldest_ndx].ne_time != 0)
+  if (!found && neighbor->ne_time != 0)
     {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_DELNEIGH,
-                           AF_INET6);
+      netlink_neigh_notify(neighbor, RTM_DELNEIGH, AF_INET6);
     }
 
   /* Need to notify when entry is not found or changes in table */
 
-  new_entry = !found || memcmp(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-                             g_neighbors[oldest_ndx].ne_addr.na_llsize) != 0;
+  new_entry = !found || memcmp(&neighbor->ne_addr.u, addr,
+                               neighbor->ne_addr.na_llsize) != 0;
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+  /* Use the matching, the unused or the least recently used entry */
+
+  neighbor->ne_dev  = dev;
+  neighbor->ne_time = clock_systime_ticks();
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
 
-  g_neighbors[oldest_ndx].ne_dev  = dev;
-  g_neighbors[oldest_ndx].ne_time = clock_systime_ticks();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  /* Make it the most recently used entry */
+
+  link = NEIGHBOR_LINK(neighbor);
+  if (found)
+    {
+      neighbor_touch(neighbor);
+    }
+  else
+    {
+      link->nl_hnext        = g_neighbor_hash[hash];
+      g_neighbor_hash[hash] = neighbor;
+      list_add_head(&g_neighbor_lru, &link->nl_node);
+    }
 
   /* Notify the new entry */
 
   if (new_entry)
     {
-      netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_NEWNEIGH,
-                           AF_INET6);
+      netlink_neigh_notify(neighbor, RTM_NEWNEIGH, AF_INET6);
     }
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
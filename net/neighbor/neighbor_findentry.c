@@ -53,19 +53,32 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_entry_s *neighbor = g_neighbor_last;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  /* Check the entry of the last lookup first, then the hash chain. */
+
+  if (neighbor == NULL || !net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      for (neighbor = g_neighbor_hash[neighbor_hash(ipaddr)];
+           neighbor != NULL;
+           neighbor = NEIGHBOR_LINK(neighbor)->nl_hnext)
+        {
+          if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+            {
+              break;
+            }
+        }
 
-      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+      if (neighbor == NULL)
         {
-          neighbor_dumpentry("Entry found", neighbor);
-          return neighbor;
+          neighbor_dumpipaddr("Not found", ipaddr);
+          return NULL;
         }
+
+      g_neighbor_last = neighbor;
     }
 
-  neighbor_dumpipaddr("Not found", ipaddr);
-  return NULL;
+  neighbor_touch(neighbor);
+  neighbor_dumpentry("Entry found", neighbor);
+  return neighbor;
 }
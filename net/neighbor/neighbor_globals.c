@@ -38,6 +38,13 @@
 
 struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The lookup state of the Neighbor Table entries */
+
+struct neighbor_link_s g_neighbor_links[CONFIG_NET_IPv6_NCONF_ENTRIES];
+FAR struct neighbor_entry_s *g_neighbor_hash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+struct list_node g_neighbor_lru = LIST_INITIAL_VALUE(g_neighbor_lru);
+FAR struct neighbor_entry_s *g_neighbor_last;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
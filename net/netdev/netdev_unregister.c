@@ -152,6 +152,10 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 #endif
       net_unlock();
 
+#ifdef CONFIG_NET_FINE_GRAINED_LOCK
+      nxrmutex_destroy(&dev->d_lock);
+#endif
+
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
       work_cancel_sync(NETDEV_STATISTICS_WORK, &dev->d_statistics.logwork);
 #endif
@@ -0,0 +1,128 @@
+/****************************************************************************
+ * net/route/lpmroute.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_LPMROUTE_H
+#define __NET_ROUTE_LPMROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lpmforeach_ipv4/net_lpmforeach_ipv6
+ *
+ * Description:
+ *   Traverse the routes whose prefix matches the target address, from the
+ *   shortest to the longest prefix.  Routes with the same prefix are
+ *   visited in routing table order.  The trie is built from the routing
+ *   table on the first call.
+ *
+ * Input Parameters:
+ *   target  - The target address to match
+ *   handler - Will be called for each matching route
+ *   arg     - An arbitrary argument that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if the traversal completed; the non-zero return
+ *   value of the handler if it terminated the traversal; -ENOSYS if the
+ *   trie could not be built, the caller must then search the routing
+ *   table itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lpmforeach_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                        FAR void *arg);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lpmforeach_ipv6(FAR const net_ipv6addr_t target,
+                        route_handler_ipv6_t handler, FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Name: net_lpmadd_ipv4/net_lpmadd_ipv6
+ *
+ * Description:
+ *   Called by the routing table backend after a route was appended to the
+ *   routing table, with the routing table locked.
+ *
+ * Input Parameters:
+ *   route - The new route
+ *
+ * Returned Value:
+ *   None.  If the trie can not be updated, it is rebuilt on the next
+ *   lookup.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_lpmadd_ipv4(FAR const struct net_route_ipv4_s *route);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_lpmadd_ipv6(FAR const struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_lpmdel_ipv4/net_lpmdel_ipv6
+ *
+ * Description:
+ *   Called by the routing table backend after the first route with this
+ *   prefix was removed from the routing table, with the routing table
+ *   locked.
+ *
+ * Input Parameters:
+ *   target  - The target address of the removed route
+ *   netmask - The network mask of the removed route
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_lpmdel_ipv4(in_addr_t target, in_addr_t netmask);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_lpmdel_ipv6(FAR const net_ipv6addr_t target,
+                     FAR const net_ipv6addr_t netmask);
+#endif
+
+#else
+#  define net_lpmadd_ipv4(r)
+#  define net_lpmadd_ipv6(r)
+#  define net_lpmdel_ipv4(t,m)
+#  define net_lpmdel_ipv6(t,m)
+#endif /* CONFIG_ROUTE_LPM */
+#endif /* __NET_ROUTE_LPMROUTE_H */
@@ -37,6 +37,7 @@
 
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
@@ -73,12 +74,24 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   net_ipv4addr_copy(route.router, router);
   net_ipv4_dumproute("New route", &route);
 
+  /* Lock the routing table so that the route trie is updated together
+   * with it.
+   */
+
+  ret = net_lockroute_ipv4();
+  if (ret < 0)
+    {
+      nerr("ERROR: net_lockroute_ipv4() failed: %d\n", ret);
+      return ret;
+    }
+
   /* Open the IPv4 routing table for append access */
 
   ret = net_openroute_ipv4(O_WRONLY | O_APPEND | O_CREAT, &fshandle);
   if (ret < 0)
     {
       nerr("ERROR: Could not open IPv4 routing table: %d\n", ret);
+      net_unlockroute_ipv4();
       return ret;
     }
 
@@ -88,6 +101,13 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_closeroute_ipv4(&fshandle);
 
+  if (nwritten >= 0)
+    {
+      net_lpmadd_ipv4(&route);
+    }
+
+  net_unlockroute_ipv4();
+
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
@@ -109,12 +129,24 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   net_ipv6addr_copy(route.router, router);
   net_ipv6_dumproute("New route", &route);
 
+  /* Lock the routing table so that the route trie is updated together
+   * with it.
+   */
+
+  ret = net_lockroute_ipv6();
+  if (ret < 0)
+    {
+      nerr("ERROR: net_lockroute_ipv6() failed: %d\n", ret);
+      return ret;
+    }
+
   /* Open the IPv6 routing table for append access */
 
   ret = net_openroute_ipv6(O_WRONLY | O_APPEND | O_CREAT, &fshandle);
   if (ret < 0)
     {
       nerr("ERROR: Could not open IPv6 routing table: %d\n", ret);
+      net_unlockroute_ipv6();
       return ret;
     }
 
@@ -124,6 +156,13 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_closeroute_ipv6(&fshandle);
 
+  if (nwritten >= 0)
+    {
+      net_lpmadd_ipv6(&route);
+    }
+
+  net_unlockroute_ipv6();
+
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET6);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
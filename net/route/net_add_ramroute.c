@@ -37,6 +37,7 @@
 #include <arch/irq.h>
 
 #include "netlink/netlink.h"
+#include "route/lpmroute.h"
 #include "route/ramroute.h"
 #include "route/route.h"
 
@@ -88,6 +89,7 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
+  net_lpmadd_ipv4(route);
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET);
@@ -125,6 +127,7 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
+  net_lpmadd_ipv6(route);
   net_unlock();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET6);
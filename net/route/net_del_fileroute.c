@@ -41,6 +41,7 @@
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
@@ -315,6 +316,10 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
   filesize = (nentries - 1) * sizeof(struct net_route_ipv4_s);
   ret = file_truncate(&fshandle, filesize);
+  if (ret >= 0)
+    {
+      net_lpmdel_ipv4(target, netmask);
+    }
 
   netlink_route_notify(&match, RTM_DELROUTE, AF_INET);
 
@@ -468,6 +473,10 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 
   filesize = (nentries - 1) * sizeof(struct net_route_ipv6_s);
   ret = file_truncate(&fshandle, filesize);
+  if (ret >= 0)
+    {
+      net_lpmdel_ipv6(target, netmask);
+    }
 
   netlink_route_notify(&match, RTM_DELROUTE, AF_INET6);
 
@@ -35,6 +35,7 @@
 #include <nuttx/net/ip.h>
 
 #include "netlink/netlink.h"
+#include "route/lpmroute.h"
 #include "route/ramroute.h"
 #include "route/route.h"
 
@@ -113,6 +114,7 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
           ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
+      net_lpmdel_ipv4(route->target, route->netmask);
       netlink_route_notify(route, RTM_DELROUTE, AF_INET);
 
       /* And free the routing table entry by adding it to the free list */
@@ -171,6 +173,7 @@ static int net_del_ipv6route(FAR struct net_route_ipv6_s *route,
           ramroute_ipv6_remfirst(&g_ipv6_routes);
         }
 
+      net_lpmdel_ipv6(route->target, route->netmask);
       netlink_route_notify(route, RTM_DELROUTE, AF_INET6);
 
       /* And free the routing table entry by adding it to the free list */
@@ -0,0 +1,818 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/fileroute.h"
+#include "route/lpmroute.h"
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The trie is protected by the lock of the routing table it indexes, which
+ * the backends already hold when they modify the table.
+ */
+
+#ifdef CONFIG_ROUTE_IPv4_FILEROUTE
+#  define lpm_lock_ipv4()   net_lockroute_ipv4()
+#  define lpm_unlock_ipv4() net_unlockroute_ipv4()
+#else
+#  define lpm_lock_ipv4()   net_lock()
+#  define lpm_unlock_ipv4() net_unlock()
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_FILEROUTE
+#  define lpm_lock_ipv6()   net_lockroute_ipv6()
+#  define lpm_unlock_ipv6() net_unlockroute_ipv6()
+#else
+#  define lpm_lock_ipv6()   net_lock()
+#  define lpm_unlock_ipv6() net_unlock()
+#endif
+
+/* The key of a node follows the node, the route of an entry follows the
+ * entry.
+ */
+
+#define LPM_KEY(n)        ((FAR uint8_t *)((n) + 1))
+#define LPM_ROUTE(e)      ((FAR void *)((e) + 1))
+
+/* Trie states */
+
+#define LPM_EMPTY         0  /* Not built yet */
+#define LPM_VALID         1  /* Matches the routing table */
+#define LPM_FAILED        2  /* Could not be built, search the table */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One route of the routing table, copied */
+
+struct lpm_entry_s
+{
+  FAR struct lpm_entry_s *flink;
+};
+
+/* A node of the path compressed binary trie.  A node holds the routes
+ * whose prefix is exactly the node's prefix, in routing table order.  A
+ * node without routes is a branch point and always has two children.
+ */
+
+struct lpm_node_s
+{
+  FAR struct lpm_node_s *child[2];
+  FAR struct lpm_entry_s *routes;
+  uint8_t plen;                   /* Prefix length in bits */
+};
+
+struct lpm_table_s
+{
+  FAR struct lpm_node_s *root;
+  uint8_t state;                  /* See LPM_* definitions */
+  uint8_t keylen;                 /* Address length in bytes */
+  uint8_t routesize;              /* Size of a routing table entry */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static struct lpm_table_s g_lpm_ipv4 =
+{
+  NULL, LPM_EMPTY, sizeof(in_addr_t), sizeof(struct net_route_ipv4_s)
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct lpm_table_s g_lpm_ipv6 =
+{
+  NULL, LPM_EMPTY, sizeof(net_ipv6addr_t), sizeof(struct net_route_ipv6_s)
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_bit
+ *
+ * Description:
+ *   Return bit 'n' of a key, counting from the most significant bit.
+ *
+ ****************************************************************************/
+
+static inline int lpm_bit(FAR const uint8_t *key, int n)
+{
+  return (key[n >> 3] >> (7 - (n & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Return the number of leading bits two keys have in common, up to
+ *   'maxbits'.
+ *
+ ****************************************************************************/
+
+static int lpm_common(FAR const uint8_t *key1, FAR const uint8_t *key2,
+                      int maxbits)
+{
+  uint8_t diff;
+  int n;
+
+  for (n = 0; n < maxbits; n += 8)
+    {
+      diff = key1[n >> 3] ^ key2[n >> 3];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              n++;
+            }
+
+          break;
+        }
+    }
+
+  return n < maxbits ? n : maxbits;
+}
+
+/****************************************************************************
+ * Name: lpm_prefix
+ *
+ * Description:
+ *   Return the prefix length of a network mask, or -EINVAL if the mask is
+ *   not contiguous and so can not be represented in the trie.
+ *
+ ****************************************************************************/
+
+static int lpm_prefix(FAR const uint8_t *mask, int keylen)
+{
+  int plen = 0;
+  int i;
+
+  for (i = 0; i < keylen && mask[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < keylen)
+    {
+      uint8_t bits = mask[i++];
+
+      while ((bits & 0x80) != 0)
+        {
+          bits <<= 1;
+          plen++;
+        }
+
+      if (bits != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (; i < keylen; i++)
+        {
+          if (mask[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: lpm_node_alloc
+ *
+ * Description:
+ *   Allocate a node for the first 'plen' bits of 'key'.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *
+lpm_node_alloc(FAR struct lpm_table_s *table, FAR const uint8_t *key,
+               int plen)
+{
+  FAR struct lpm_node_s *node;
+  int nbytes = (plen + 7) >> 3;
+
+  node = kmm_zalloc(sizeof(struct lpm_node_s) + table->keylen);
+  if (node != NULL)
+    {
+      memcpy(LPM_KEY(node), key, nbytes);
+      if ((plen & 7) != 0)
+        {
+          LPM_KEY(node)[nbytes - 1] &= 0xff << (8 - (plen & 7));
+        }
+
+      node->plen = plen;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: lpm_clear
+ *
+ * Description:
+ *   Free all nodes and entries of the trie and set its new state.  A trie
+ *   that is out of date is only marked LPM_EMPTY and freed here before it
+ *   is rebuilt.  The nodes are freed
+ *   iteratively, rotating left subtrees to the right so that no stack is
+ *   needed.
+ *
+ ****************************************************************************/
+
+static void lpm_clear(FAR struct lpm_table_s *table, uint8_t state)
+{
+  FAR struct lpm_node_s *node = table->root;
+  FAR struct lpm_node_s *next;
+  FAR struct lpm_entry_s *entry;
+
+  while (node != NULL)
+    {
+      if (node->child[0] != NULL)
+        {
+          next           = node->child[0];
+          node->child[0] = next->child[1];
+          next->child[1] = node;
+        }
+      else
+        {
+          next = node->child[1];
+          while ((entry = node->routes) != NULL)
+            {
+              node->routes = entry->flink;
+              kmm_free(entry);
+            }
+
+          kmm_free(node);
+        }
+
+      node = next;
+    }
+
+  table->root  = NULL;
+  table->state = state;
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ *
+ * Description:
+ *   Add a copy of a route after the routes with the same prefix.
+ *
+ ****************************************************************************/
+
+static int lpm_insert(FAR struct lpm_table_s *table,
+                      FAR const uint8_t *target, FAR const uint8_t *mask,
+                      FAR const void *route)
+{
+  FAR struct lpm_node_s **pnode = &table->root;
+  FAR struct lpm_entry_s **pentry;
+  FAR struct lpm_entry_s *entry;
+  FAR struct lpm_node_s *node;
+  FAR struct lpm_node_s *leaf;
+  FAR struct lpm_node_s *fork;
+  int plen;
+  int n;
+
+  plen = lpm_prefix(mask, table->keylen);
+  if (plen < 0)
+    {
+      return plen;
+    }
+
+  entry = kmm_malloc(sizeof(struct lpm_entry_s) + table->routesize);
+  if (entry == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  entry->flink = NULL;
+  memcpy(LPM_ROUTE(entry), route, table->routesize);
+
+  /* Walk down while the node's prefix is a prefix of the new one */
+
+  while ((node = *pnode) != NULL)
+    {
+      n = lpm_common(LPM_KEY(node), target,
+                     node->plen < plen ? node->plen : plen);
+      if (n < node->plen)
+        {
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          /* Same prefix, append the route */
+
+          for (pentry = &node->routes; *pentry != NULL;
+               pentry = &(*pentry)->flink);
+
+          *pentry = entry;
+          return OK;
+        }
+
+      pnode = &node->child[lpm_bit(target, node->plen)];
+    }
+
+  leaf = lpm_node_alloc(table, target, plen);
+  if (leaf == NULL)
+    {
+      kmm_free(entry);
+      return -ENOMEM;
+    }
+
+  leaf->routes = entry;
+
+  if (node == NULL)
+    {
+      /* Empty subtree */
+
+      *pnode = leaf;
+    }
+  else if (n == plen)
+    {
+      /* The new prefix is a prefix of the node's one */
+
+      leaf->child[lpm_bit(LPM_KEY(node), plen)] = node;
+      *pnode = leaf;
+    }
+  else
+    {
+      /* The prefixes diverge at bit n, add a branch point there */
+
+      fork = lpm_node_alloc(table, target, n);
+      if (fork == NULL)
+        {
+          kmm_free(leaf);
+          kmm_free(entry);
+          return -ENOMEM;
+        }
+
+      fork->child[lpm_bit(target, n)] = leaf;
+      fork->child[lpm_bit(LPM_KEY(node), n)] = node;
+      *pnode = fork;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_remove
+ *
+ * Description:
+ *   Remove the first route with this prefix and the nodes that are no
+ *   longer needed.
+ *
+ ****************************************************************************/
+
+static int lpm_remove(FAR struct lpm_table_s *table,
+                      FAR const uint8_t *target, FAR const uint8_t *mask)
+{
+  FAR struct lpm_node_s **pparent = NULL;
+  FAR struct lpm_node_s **pnode = &table->root;
+  FAR struct lpm_entry_s *entry;
+  FAR struct lpm_node_s *parent;
+  FAR struct lpm_node_s *node;
+  int plen;
+
+  plen = lpm_prefix(mask, table->keylen);
+  if (plen < 0)
+    {
+      return plen;
+    }
+
+  while ((node = *pnode) != NULL && node->plen < plen)
+    {
+      if (lpm_common(LPM_KEY(node), target, node->plen) < node->plen)
+        {
+          return -ENOENT;
+        }
+
+      pparent = pnode;
+      pnode   = &node->child[lpm_bit(target, node->plen)];
+    }
+
+  if (node == NULL || node->plen != plen || node->routes == NULL ||
+      lpm_common(LPM_KEY(node), target, plen) < plen)
+    {
+      return -ENOENT;
+    }
+
+  entry        = node->routes;
+  node->routes = entry->flink;
+  kmm_free(entry);
+
+  if (node->routes != NULL ||
+      (node->child[0] != NULL && node->child[1] != NULL))
+    {
+      return OK;
+    }
+
+  /* Replace the node by its only child, if any */
+
+  *pnode = node->child[0] != NULL ? node->child[0] : node->child[1];
+  kmm_free(node);
+
+  /* If the node was a leaf below a branch point, the branch point is left
+   * with one child and is not needed any more.
+   */
+
+  if (*pnode == NULL && pparent != NULL)
+    {
+      parent = *pparent;
+      if (parent->routes == NULL)
+        {
+          *pparent = parent->child[0] != NULL ?
+                     parent->child[0] : parent->child[1];
+          kmm_free(parent);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_next
+ *
+ * Description:
+ *   Return the next node below 'node' (or the first node if 'node' is
+ *   NULL) that has routes and whose prefix matches the address.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_next(FAR struct lpm_table_s *table,
+                                       FAR const uint8_t *addr,
+                                       FAR struct lpm_node_s *node)
+{
+  int nbits = table->keylen << 3;
+
+  if (node == NULL)
+    {
+      node = table->root;
+    }
+  else if (node->plen < nbits)
+    {
+      node = node->child[lpm_bit(addr, node->plen)];
+    }
+  else
+    {
+      return NULL;
+    }
+
+  while (node != NULL &&
+         lpm_common(LPM_KEY(node), addr, node->plen) == node->plen)
+    {
+      if (node->routes != NULL)
+        {
+          return node;
+        }
+
+      node = node->child[lpm_bit(addr, node->plen)];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: lpm_update
+ *
+ * Description:
+ *   Apply the result of an incremental update.  If it failed, the trie no
+ *   longer matches the routing table and is rebuilt on the next lookup.
+ *
+ ****************************************************************************/
+
+static void lpm_update(FAR struct lpm_table_s *table, int ret)
+{
+  if (ret < 0)
+    {
+      nwarn("WARNING: Route trie update failed: %d\n", ret);
+      table->state = LPM_EMPTY;
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_build_ipv4/lpm_build_ipv6
+ *
+ * Description:
+ *   Add one route of the routing table to the trie being built.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int lpm_build_ipv4(FAR struct net_route_ipv4_s *route,
+                          FAR void *arg)
+{
+  return lpm_insert(&g_lpm_ipv4, (FAR const uint8_t *)&route->target,
+                    (FAR const uint8_t *)&route->netmask, route) < 0;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int lpm_build_ipv6(FAR struct net_route_ipv6_s *route,
+                          FAR void *arg)
+{
+  return lpm_insert(&g_lpm_ipv6, (FAR const uint8_t *)route->target,
+                    (FAR const uint8_t *)route->netmask, route) < 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lpmforeach_ipv4/net_lpmforeach_ipv6
+ *
+ * Description:
+ *   Traverse the routes whose prefix matches the target address, from the
+ *   shortest to the longest prefix.  Routes with the same prefix are
+ *   visited in routing table order.  The trie is built from the routing
+ *   table on the first call.
+ *
+ * Input Parameters:
+ *   target  - The target address to match
+ *   handler - Will be called for each matching route
+ *   arg     - An arbitrary argument that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if the traversal completed; the non-zero return
+ *   value of the handler if it terminated the traversal; -ENOSYS if the
+ *   trie could not be built, the caller must then search the routing
+ *   table itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lpmforeach_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                        FAR void *arg)
+{
+  FAR struct lpm_node_s *node = NULL;
+  FAR struct lpm_entry_s *entry;
+  int ret;
+
+  ret = lpm_lock_ipv4();
+  if (ret < 0)
+    {
+      return -ENOSYS;
+    }
+
+  if (g_lpm_ipv4.state == LPM_EMPTY)
+    {
+      lpm_clear(&g_lpm_ipv4, LPM_VALID);
+      if (net_foreachroute_ipv4(lpm_build_ipv4, NULL) != 0)
+        {
+          nwarn("WARNING: Failed to build the IPv4 route trie\n");
+          lpm_clear(&g_lpm_ipv4, LPM_FAILED);
+        }
+    }
+
+  if (g_lpm_ipv4.state != LPM_VALID)
+    {
+      lpm_unlock_ipv4();
+      return -ENOSYS;
+    }
+
+  ret = 0;
+  while (ret == 0 &&
+         (node = lpm_next(&g_lpm_ipv4, (FAR const uint8_t *)&target,
+                          node)) != NULL)
+    {
+      for (entry = node->routes; ret == 0 && entry != NULL;
+           entry = entry->flink)
+        {
+          ret = handler(LPM_ROUTE(entry), arg);
+        }
+    }
+
+  lpm_unlock_ipv4();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lpmforeach_ipv6(FAR const net_ipv6addr_t target,
+                        route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR struct lpm_node_s *node = NULL;
+  FAR struct lpm_entry_s *entry;
+  int ret;
+
+  ret = lpm_lock_ipv6();
+  if (ret < 0)
+    {
+      return -ENOSYS;
+    }
+
+  if (g_lpm_ipv6.state == LPM_EMPTY)
+    {
+      lpm_clear(&g_lpm_ipv6, LPM_VALID);
+      if (net_foreachroute_ipv6(lpm_build_ipv6, NULL) != 0)
+        {
+          nwarn("WARNING: Failed to build the IPv6 route trie\n");
+          lpm_clear(&g_lpm_ipv6, LPM_FAILED);
+        }
+    }
+
+  if (g_lpm_ipv6.state != LPM_VALID)
+    {
+      lpm_unlock_ipv6();
+      return -ENOSYS;
+    }
+
+  ret = 0;
+  while (ret == 0 &&
+         (node = lpm_next(&g_lpm_ipv6, (FAR const uint8_t *)target,
+                          node)) != NULL)
+    {
+      for (entry = node->routes; ret == 0 && entry != NULL;
+           entry = entry->flink)
+        {
+          ret = handler(LPM_ROUTE(entry), arg);
+        }
+    }
+
+  lpm_unlock_ipv6();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpmadd_ipv4/net_lpmadd_ipv6
+ *
+ * Description:
+ *   Called by the routing table backend after a route was appended to the
+ *   routing table, with the routing table locked.
+ *
+ * Input Parameters:
+ *   route - The new route
+ *
+ * Returned Value:
+ *   None.  If the trie can not be updated, it is rebuilt on the next
+ *   lookup.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_lpmadd_ipv4(FAR const struct net_route_ipv4_s *route)
+{
+  if (lpm_lock_ipv4() < 0)
+    {
+      g_lpm_ipv4.state = LPM_EMPTY;
+      return;
+    }
+
+  if (g_lpm_ipv4.state == LPM_VALID)
+    {
+      lpm_update(&g_lpm_ipv4,
+                 lpm_insert(&g_lpm_ipv4,
+                            (FAR const uint8_t *)&route->target,
+                            (FAR const uint8_t *)&route->netmask, route));
+    }
+  else
+    {
+      g_lpm_ipv4.state = LPM_EMPTY;
+    }
+
+  lpm_unlock_ipv4();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_lpmadd_ipv6(FAR const struct net_route_ipv6_s *route)
+{
+  if (lpm_lock_ipv6() < 0)
+    {
+      g_lpm_ipv6.state = LPM_EMPTY;
+      return;
+    }
+
+  if (g_lpm_ipv6.state == LPM_VALID)
+    {
+      lpm_update(&g_lpm_ipv6,
+                 lpm_insert(&g_lpm_ipv6,
+                            (FAR const uint8_t *)route->target,
+                            (FAR const uint8_t *)route->netmask, route));
+    }
+  else
+    {
+      g_lpm_ipv6.state = LPM_EMPTY;
+    }
+
+  lpm_unlock_ipv6();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpmdel_ipv4/net_lpmdel_ipv6
+ *
+ * Description:
+ *   Called by the routing table backend after the first route with this
+ *   prefix was removed from the routing table, with the routing table
+ *   locked.
+ *
+ * Input Parameters:
+ *   target  - The target address of the removed route
+ *   netmask - The network mask of the removed route
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_lpmdel_ipv4(in_addr_t target, in_addr_t netmask)
+{
+  if (lpm_lock_ipv4() < 0)
+    {
+      g_lpm_ipv4.state = LPM_EMPTY;
+      return;
+    }
+
+  if (g_lpm_ipv4.state == LPM_VALID)
+    {
+      lpm_update(&g_lpm_ipv4,
+                 lpm_remove(&g_lpm_ipv4, (FAR const uint8_t *)&target,
+                            (FAR const uint8_t *)&netmask));
+    }
+  else
+    {
+      g_lpm_ipv4.state = LPM_EMPTY;
+    }
+
+  lpm_unlock_ipv4();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_lpmdel_ipv6(FAR const net_ipv6addr_t target,
+                     FAR const net_ipv6addr_t netmask)
+{
+  if (lpm_lock_ipv6() < 0)
+    {
+      g_lpm_ipv6.state = LPM_EMPTY;
+      return;
+    }
+
+  if (g_lpm_ipv6.state == LPM_VALID)
+    {
+      lpm_update(&g_lpm_ipv6,
+                 lpm_remove(&g_lpm_ipv6, (FAR const uint8_t *)target,
+                            (FAR const uint8_t *)netmask));
+    }
+  else
+    {
+      g_lpm_ipv6.state = LPM_EMPTY;
+    }
+
+  lpm_unlock_ipv6();
+}
+#endif
+
+#endif /* CONFIG_ROUTE_LPM */
@@ -36,6 +36,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 #include "utils/utils.h"
 
@@ -283,7 +284,13 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
        * routing table that can forward to this address
        */
 
-      ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+#ifdef CONFIG_ROUTE_LPM
+      ret = net_lpmforeach_ipv4(target, net_ipv4_match, &match);
+      if (ret == -ENOSYS)
+#endif
+        {
+          ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+        }
     }
 
   /* Did we find a route? */
@@ -377,7 +384,13 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
        * routing table that can forward to this address
        */
 
-      ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+#ifdef CONFIG_ROUTE_LPM
+      ret = net_lpmforeach_ipv6(target, net_ipv6_match, &match);
+      if (ret == -ENOSYS)
+#endif
+        {
+          ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+        }
     }
 
   /* Did we find a route? */
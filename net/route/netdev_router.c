@@ -35,6 +35,7 @@
 
 #include "netdev/netdev.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 #include "utils/utils.h"
 
@@ -284,7 +285,13 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
        * routing table that can forward to this address
        */
 
-      ret = net_foreachroute_ipv4(net_ipv4_devmatch, &match);
+#ifdef CONFIG_ROUTE_LPM
+      ret = net_lpmforeach_ipv4(target, net_ipv4_devmatch, &match);
+      if (ret == -ENOSYS)
+#endif
+        {
+          ret = net_foreachroute_ipv4(net_ipv4_devmatch, &match);
+        }
     }
 
   /* Did we find a route? */
@@ -371,7 +378,13 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
        * routing table that can forward to this address
        */
 
-      ret = net_foreachroute_ipv6(net_ipv6_devmatch, &match);
+#ifdef CONFIG_ROUTE_LPM
+      ret = net_lpmforeach_ipv6(target, net_ipv6_devmatch, &match);
+      if (ret == -ENOSYS)
+#endif
+        {
+          ret = net_foreachroute_ipv6(net_ipv6_devmatch, &match);
+        }
     }
 
   /* Did we find a route? */
@@ -0,0 +1,194 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives multiple messages from a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to recvmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Buffers to receive the messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags
+ *   timeout  The maximum time to spend receiving, NULL to not time out
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received, and the msg_len
+ *   member of each of them holds the number of bytes received.  If the
+ *   first message cannot be received, a negated errno value is returned
+ *   (see comments with recvmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout)
+{
+  clock_t deadline = 0;
+  unsigned int i;
+  ssize_t ret = OK;
+  int rflags = flags & ~MSG_WAITFORONE;
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (timeout != NULL)
+    {
+      if (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+          timeout->tv_nsec >= NSEC_PER_SEC)
+        {
+          return -EINVAL;
+        }
+
+      deadline = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+  for (i = 0; i < vlen; i++)
+    {
+      ret = psock_recvmsg(psock, &msgvec[i].msg_hdr, rflags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+
+      /* Only wait for the first message if so requested */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          rflags |= MSG_DONTWAIT;
+        }
+
+      /* As on other systems, the timeout is only checked after each
+       * message received.  It does not limit the wait for a message.
+       */
+
+      if (timeout != NULL && clock_compare(deadline, clock_systime_ticks()))
+        {
+          i++;
+          break;
+        }
+    }
+
+  return i > 0 ? (int)i : (int)ret;
+}
+
+/****************************************************************************
+ * Name: recvmmsg
+ *
+ * Description:
+ *   The recvmmsg() call receives multiple messages from a socket with a
+ *   single call.  It is equivalent to calling recvmsg() for each of the
+ *   'vlen' messages in 'msgvec'.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Buffers to receive the messages
+ *   vlen     The number of messages in msgvec
+ *   flags    Receive flags.  In addition to the flags of recvmsg(),
+ *            MSG_WAITFORONE turns on MSG_DONTWAIT after the first message
+ *            has been received.
+ *   timeout  The maximum time to spend receiving, NULL to not time out
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received in msgvec, and the
+ *   msg_len member of each of them holds the number of bytes received.  If
+ *   an error occurs before any message is received, -1 is returned and
+ *   errno is set as for recvmsg().  An error after the first message is
+ *   not reported; the number of messages received so far is returned
+ *   instead.
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
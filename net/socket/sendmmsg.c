@@ -0,0 +1,180 @@
+/****************************************************************************
+ * net/socket/sendmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends multiple messages to a socket.  This is an
+ *   internal OS interface.  It is functionally equivalent to sendmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ *   For UDP sockets, the network is locked only once for the whole batch.
+ *   The datagrams are all queued before the network device gets to poll
+ *   for them, so that the device is only notified once.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The messages to send
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent, and the msg_len
+ *   member of each of them holds the number of bytes sent.  If sending the
+ *   first message fails, a negated errno value is returned (see comments
+ *   with sendmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags)
+{
+  bool batch = false;
+  unsigned int i;
+  ssize_t ret = OK;
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+#ifdef CONFIG_NET_UDP
+  /* Every UDP send locks the network anyway.  Any wait for resources
+   * breaks the lock, so it is safe to hold it across the batch.
+   */
+
+  batch = psock->s_type == SOCK_DGRAM &&
+          (psock->s_domain == PF_INET || psock->s_domain == PF_INET6);
+  if (batch)
+    {
+      net_lock();
+    }
+#endif
+
+  for (i = 0; i < vlen; i++)
+    {
+      ret = psock_sendmsg(psock, &msgvec[i].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+    }
+
+  if (batch)
+    {
+      net_unlock();
+    }
+
+  return i > 0 ? (int)i : (int)ret;
+}
+
+/****************************************************************************
+ * Name: sendmmsg
+ *
+ * Description:
+ *   The sendmmsg() call sends multiple messages on a socket with a single
+ *   call.  It is equivalent to calling sendmsg() for each of the 'vlen'
+ *   messages in 'msgvec'.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   The messages to send
+ *   vlen     The number of messages in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent from msgvec, and the
+ *   msg_len member of each of them holds the number of bytes sent.  If an
+ *   error occurs before any message is sent, -1 is returned and errno is
+ *   set as for sendmsg().  An error after the first message is not
+ *   reported; the number of messages sent so far is returned instead.
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* sendmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_sendmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_sendmmsg(psock, msgvec, vlen, flags);
+      fs_putfilep(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -208,6 +209,10 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hash_node_t connhash;   /* Active connections by remote address & ports */
+  hash_node_t porthash;   /* Active connections by local port */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
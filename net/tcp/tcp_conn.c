@@ -95,10 +95,187 @@ NET_BUFPOOL_DECLARE(g_tcp_connections, sizeof(struct tcp_conn_s),
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The active TCP connections hashed by remote address and ports, and by
+ * local port.
+ */
+
+static DECLARE_HASHTABLE(g_tcp_connhash, CONFIG_NET_TCP_CONN_HASH_BITS);
+static DECLARE_HASHTABLE(g_tcp_porthash, CONFIG_NET_TCP_CONN_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_ipv4_hashkey and tcp_ipv6_hashkey
+ *
+ * Description:
+ *   Create the connection hash key from the remote address and the ports.
+ *   The local address is left out because a connection may be bound to
+ *   the unspecified address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_hashkey(in_addr_t raddr, uint16_t lport,
+                                        uint16_t rport)
+{
+  return (uint32_t)raddr ^ ((uint32_t)lport << 16) ^ rport;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_hashkey(const net_ipv6addr_t raddr,
+                                        uint16_t lport, uint16_t rport)
+{
+  uint32_t key = (((uint32_t)raddr[0] << 16) | raddr[1]) ^
+                 (((uint32_t)raddr[2] << 16) | raddr[3]) ^
+                 (((uint32_t)raddr[4] << 16) | raddr[5]) ^
+                 (((uint32_t)raddr[6] << 16) | raddr[7]);
+
+  return key ^ ((uint32_t)lport << 16) ^ rport;
+}
+#endif
+
+#ifdef CONFIG_NET_TCP_CONN_HASH
+
+/****************************************************************************
+ * Name: tcp_conn_hashkey
+ *
+ * Description:
+ *   Create the connection hash key of an active connection.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_conn_hashkey(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      return tcp_ipv6_hashkey(conn->u.ipv6.raddr, conn->lport,
+                              conn->rport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return tcp_ipv4_hashkey(conn->u.ipv4.raddr, conn->lport,
+                              conn->rport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
+/****************************************************************************
+ * Name: tcp_conn_hashadd and tcp_conn_hashdel
+ *
+ * Description:
+ *   Add an active connection to or remove it from the hashtables.  The
+ *   addresses and ports must not change in between.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_conn_hashadd(FAR struct tcp_conn_s *conn)
+{
+  hashtable_add(g_tcp_connhash, &conn->connhash, tcp_conn_hashkey(conn));
+  hashtable_add(g_tcp_porthash, &conn->porthash, conn->lport);
+}
+
+static void tcp_conn_hashdel(FAR struct tcp_conn_s *conn)
+{
+  hashtable_delete(g_tcp_connhash, &conn->connhash,
+                   tcp_conn_hashkey(conn));
+  hashtable_delete(g_tcp_porthash, &conn->porthash, conn->lport);
+}
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
+/****************************************************************************
+ * Name: tcp_conn_first and tcp_conn_next
+ *
+ * Description:
+ *   Iterate over the active connections that may match the connection
+ *   hash 'key': the connections in its bucket if the connections are
+ *   hashed, all active connections otherwise.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *tcp_conn_first(uint32_t key)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node;
+
+  node = g_tcp_connhash[HASH(key, hashtable_bits(g_tcp_connhash))].head;
+  return node != NULL ?
+         container_of(node, struct tcp_conn_s, connhash) : NULL;
+#else
+  return (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+}
+
+static inline FAR struct tcp_conn_s *
+  tcp_conn_next(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node = conn->connhash.flink;
+
+  return node != NULL ?
+         container_of(node, struct tcp_conn_s, connhash) : NULL;
+#else
+  return (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_port_first and tcp_port_next
+ *
+ * Description:
+ *   Iterate over the active connections that may use the local port
+ *   'portno': the connections in its bucket if the connections are hashed,
+ *   all active connections otherwise.
+ *
+ * Assumptions:
+ *   This function is called with the network locked.
+ *
+ ****************************************************************************/
+
+static inline FAR struct tcp_conn_s *tcp_port_first(uint16_t portno)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node;
+
+  node = g_tcp_porthash[HASH(portno, hashtable_bits(g_tcp_porthash))].head;
+  return node != NULL ?
+         container_of(node, struct tcp_conn_s, porthash) : NULL;
+#else
+  return (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+}
+
+static inline FAR struct tcp_conn_s *
+  tcp_port_next(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *node = conn->porthash.flink;
+
+  return node != NULL ?
+         container_of(node, struct tcp_conn_s, porthash) : NULL;
+#else
+  return (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -115,11 +292,12 @@ static FAR struct tcp_conn_s *
   tcp_listener(uint8_t domain, FAR const union ip_addr_u *ipaddr,
                uint16_t portno)
 {
-  FAR struct tcp_conn_s *conn = NULL;
+  FAR struct tcp_conn_s *conn;
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
-  while ((conn = tcp_nextconn(conn)) != NULL)
+  for (conn = tcp_port_first(portno); conn != NULL;
+       conn = tcp_port_next(conn))
     {
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -192,12 +370,13 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
+  uint32_t key;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
-  while (conn)
+  key = tcp_ipv4_hashkey(srcipaddr, tcp->destport, tcp->srcport);
+  for (conn = tcp_conn_first(key); conn != NULL; conn = tcp_conn_next(conn))
     {
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
@@ -223,19 +402,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
           net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -259,12 +432,13 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
+  uint32_t key;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
-  while (conn)
+  key = tcp_ipv6_hashkey(*srcipaddr, tcp->destport, tcp->srcport);
+  for (conn = tcp_conn_first(key); conn != NULL; conn = tcp_conn_next(conn))
     {
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
@@ -290,19 +464,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
           net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -606,6 +774,10 @@ int tcp_selectport(uint8_t domain,
 
 void tcp_initialize(void)
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_init(g_tcp_connhash);
+  hashtable_init(g_tcp_porthash);
+#endif
 }
 
 /****************************************************************************
@@ -858,6 +1030,9 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      tcp_conn_hashdel(conn);
+#endif
     }
 
   tcp_free_rx_buffers(conn);
@@ -1155,6 +1330,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      tcp_conn_hashadd(conn);
+#endif
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1466,6 +1644,9 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  tcp_conn_hashadd(conn);
+#endif
   ret = OK;
 
 errout_with_lock:
@@ -134,6 +134,14 @@ struct udp_conn_s
 
   FAR struct iob_s *readahead;   /* Read-ahead buffering */
 
+#ifdef CONFIG_NET_UDP_ZEROCOPY
+  /* I/O buffer chains lent to the user by SIOCRECVIOB and not yet given
+   * back with SIOCFREEIOB.
+   */
+
+  struct iob_queue_s lent;
+#endif
+
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Write buffering
    *
@@ -213,7 +213,9 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 
   /* Concat the iob to readahead */
 
+  conn_lock(conn);
   net_iob_concat(&conn->readahead, &iob);
+  conn_unlock(conn);
 
 #ifdef CONFIG_NET_UDP_NOTIFIER
   ninfo("Buffered %d bytes\n", buflen);
@@ -589,6 +589,8 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       nxsem_init(&conn->sndsem, 0, 0);
 #endif
 
+      conn_lock_init(conn);
+
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
       /* Initialize the write buffer lists */
 
@@ -632,6 +634,13 @@ void udp_free(FAR struct udp_conn_s *conn)
   /* Release any read-ahead buffers attached to the connection, NULL is ok */
 
   iob_free_chain(conn->readahead);
+  conn_lock_destroy(conn);
+
+#ifdef CONFIG_NET_UDP_ZEROCOPY
+  /* Release the buffers that were lent out and never given back */
+
+  iob_free_queue(&conn->lent);
+#endif
 
 #ifdef CONFIG_NET_UDP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
@@ -32,11 +32,15 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <string.h>
+
 #include <net/if.h>
 
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/net/ioctl.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/udp.h>
 
 #include "udp/udp.h"
 
@@ -91,6 +95,186 @@ static void udp_path(FAR struct udp_conn_s *conn, FAR char *buf, size_t len)
            );
 }
 
+/****************************************************************************
+ * Name: udp_recviob
+ *
+ * Description:
+ *   Remove the next datagram from the read-ahead buffer and lend the I/O
+ *   buffer chain holding its payload to the caller.
+ *
+ * Parameters:
+ *   conn     The UDP connection of interest
+ *   ui       Returns the payload and the source address of the datagram
+ *
+ * Returned Value:
+ *   OK on success; -EAGAIN if no datagram is available; a negated errno
+ *   value on any other failure.  The length of the datagram is the
+ *   io_pktlen of the lent chain.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_ZEROCOPY
+static int udp_recviob(FAR struct udp_conn_s *conn,
+                       FAR struct udp_iob_s *ui)
+{
+  FAR struct iob_s *iob = conn->readahead;
+  FAR struct iob_s *last;
+  FAR struct iob_s *copy;
+  unsigned int offset = 0;
+  unsigned int total;
+  unsigned int len = 0;
+  uint16_t datalen;
+  uint8_t src_addr_size;
+  int ret;
+
+  if (iob == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  /* Parse the header of the datagram, see udp_datahandler() */
+
+  iob_copyout((FAR uint8_t *)&datalen, iob, sizeof(datalen), offset);
+  offset += sizeof(datalen);
+#ifdef CONFIG_NETDEV_IFINDEX
+  offset += sizeof(uint8_t);
+#endif
+  iob_copyout(&src_addr_size, iob, sizeof(src_addr_size), offset);
+  offset += sizeof(src_addr_size);
+
+  ui->ui_fromlen = MIN(src_addr_size, sizeof(ui->ui_from));
+  iob_copyout((FAR uint8_t *)&ui->ui_from, iob, ui->ui_fromlen, offset);
+  offset += src_addr_size;
+#ifdef CONFIG_NET_TIMESTAMP
+  offset += sizeof(struct timespec);
+#endif
+
+  total = offset + datalen;
+  if (total < iob->io_pktlen)
+    {
+      /* Other datagrams follow.  Find the I/O buffer where this one ends */
+
+      for (last = iob; last != NULL; last = last->io_flink)
+        {
+          len += last->io_len;
+          if (len >= total)
+            {
+              break;
+            }
+        }
+
+      DEBUGASSERT(last != NULL && last->io_flink != NULL);
+
+      if (len > total)
+        {
+          /* The next datagram was packed into the same I/O buffer.  Only
+           * the payload can be copied in this case.
+           */
+
+          copy = iob_tryalloc(false);
+          if (copy == NULL)
+            {
+              return -ENOBUFS;
+            }
+
+          ret = iob_clone_partial(iob, datalen, offset, copy, 0,
+                                  false, false);
+          if (ret < 0)
+            {
+              iob_free_chain(copy);
+              return ret;
+            }
+
+          conn->readahead = iob_trimhead(iob, total);
+          ui->ui_iob = copy;
+          return OK;
+        }
+
+      /* Split the chain after the datagram */
+
+      conn->readahead = last->io_flink;
+      conn->readahead->io_pktlen = iob->io_pktlen - total;
+      last->io_flink  = NULL;
+      iob->io_pktlen  = total;
+    }
+  else
+    {
+      conn->readahead = NULL;
+    }
+
+  ui->ui_iob = iob_trimhead(iob, offset);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: udp_lendiob
+ *
+ * Description:
+ *   Lend the I/O buffer chain of the next datagram to the caller and record
+ *   it in the list of lent chains of the connection.
+ *
+ * Parameters:
+ *   conn     The UDP connection of interest
+ *   ui       Returns the payload and the source address of the datagram
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.  If the chain cannot
+ *   be recorded, the datagram is dropped and -ENOBUFS is returned.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+static int udp_lendiob(FAR struct udp_conn_s *conn,
+                       FAR struct udp_iob_s *ui)
+{
+  int ret;
+
+  ret = udp_recviob(conn, ui);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = iob_tryadd_queue(ui->ui_iob, &conn->lent);
+  if (ret < 0)
+    {
+      iob_free_chain(ui->ui_iob);
+      ui->ui_iob = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: udp_freeiob
+ *
+ * Description:
+ *   Free an I/O buffer chain that was lent to the caller by SIOCRECVIOB.
+ *
+ * Parameters:
+ *   conn     The UDP connection of interest
+ *   iob      The lent I/O buffer chain
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if the chain was not lent out by this
+ *   connection.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+static int udp_freeiob(FAR struct udp_conn_s *conn, FAR struct iob_s *iob)
+{
+  return iob_free_queue_qentry(iob, &conn->lent) < 0 ? -EINVAL : OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -114,6 +298,7 @@ int udp_ioctl(FAR struct udp_conn_s *conn, int cmd, unsigned long arg)
   int ret = OK;
 
   net_lock();
+  conn_lock(conn);
 
   switch (cmd)
     {
@@ -146,11 +331,20 @@ int udp_ioctl(FAR struct udp_conn_s *conn, int cmd, unsigned long arg)
       case FIOC_FILEPATH:
         udp_path(conn, (FAR char *)(uintptr_t)arg, PATH_MAX);
         break;
+#ifdef CONFIG_NET_UDP_ZEROCOPY
+      case SIOCRECVIOB:
+        ret = udp_lendiob(conn, (FAR struct udp_iob_s *)((uintptr_t)arg));
+        break;
+      case SIOCFREEIOB:
+        ret = udp_freeiob(conn, (FAR struct iob_s *)((uintptr_t)arg));
+        break;
+#endif
       default:
         ret = -ENOTTY;
         break;
     }
 
+  conn_unlock(conn);
   net_unlock();
 
   return ret;
@@ -181,6 +181,7 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 
   pstate->ir_recvlen = -1;
 
+  conn_lock(conn);
   if ((iob = conn->readahead) != NULL)
     {
       int recvlen;
@@ -275,6 +276,8 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
             }
         }
     }
+
+  conn_unlock(conn);
 }
 
 /****************************************************************************
@@ -690,14 +693,33 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
       return -ENOTSUP;
     }
 
-  /* Initialize the state structure.  This is done with the network locked
-   * because we don't want anything to happen until we are ready.
+  /* Initialize the state structure */
+
+  udp_recvfrom_initialize(conn, msg, &state, flags);
+
+#ifdef CONFIG_NET_FINE_GRAINED_LOCK
+  /* The read-ahead queue is protected by the connection lock.  If a
+   * datagram is already queued, it can be received without taking the
+   * network lock at all.
+   */
+
+  udp_readahead(&state);
+  if (state.ir_recvlen >= 0)
+    {
+      udp_recvfrom_uninitialize(&state);
+      return state.ir_recvlen;
+    }
+#endif
+
+  /* Nothing happens to the connection from here on until we are ready,
+   * because the network is locked.
    */
 
   net_lock();
-  udp_recvfrom_initialize(conn, msg, &state, flags);
 
-  /* Copy the read-ahead data from the packet */
+  /* Copy the read-ahead data from the packet.  With the fine grained lock,
+   * a datagram may have been queued since the attempt above.
+   */
 
   udp_readahead(&state);
 
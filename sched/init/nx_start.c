@@ -94,6 +94,12 @@
 
 dq_queue_t g_readytorun;
 
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+/* Priority index of the g_readytorun list.  See struct rtrindex_s. */
+
+struct rtrindex_s g_rtrindex;
+#endif
+
 /* In order to support SMP, the function of the g_readytorun list changes,
  * The g_readytorun is still used but in the SMP case it will contain only:
  *
@@ -425,6 +431,10 @@ static void idle_task_initialize(void)
       tasklist = TLIST_HEAD(tcb);
 #endif
       dq_addfirst((FAR dq_entry_t *)tcb, tasklist);
+      if (tasklist == list_readytorun())
+        {
+          nxsched_rtrindex_add(tcb);
+        }
 
       /* Mark the idle task as the running task */
 
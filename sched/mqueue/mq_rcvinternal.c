@@ -115,6 +115,10 @@ static void nxmq_rcvtimeout(wdparm_t arg)
  *   On success, zero (OK) is returned.  A negated errno value is returned
  *   on any failure.
  *
+ *   With CONFIG_MQ_RECEIVE_HANDOFF, the message may instead have been
+ *   copied to the buffer registered in the waitbuf field of the caller's
+ *   TCB.  In that case, waitbuf is NULL and *rcvmsg is NULL on return.
+ *
  * Assumptions:
  * - The caller has provided all validity checking of the input parameters
  *   using nxmq_verify_receive.
@@ -160,8 +164,7 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
 
   /* Get the message from the head of the queue */
 
-  while ((newmsg = (FAR struct mqueue_msg_s *)
-                   list_remove_head(&msgq->msglist)) == NULL)
+  while ((newmsg = nxmq_remove_queue(msgq)) == NULL)
     {
       msgq->cmn.nwaitnotempty++;
 
@@ -195,6 +198,15 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
         {
           break;
         }
+
+#ifdef CONFIG_MQ_RECEIVE_HANDOFF
+      /* The sender may have copied its message directly to our buffer */
+
+      if (rtcb->waitbuf == NULL)
+        {
+          break;
+        }
+#endif
     }
 
   if (abstime || ticks >= 0)
@@ -39,6 +39,7 @@
 #include <nuttx/mqueue.h>
 #include <nuttx/cancelpt.h>
 
+#include "sched/sched.h"
 #include "mqueue/mqueue.h"
 
 /****************************************************************************
@@ -142,6 +143,10 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 {
   FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
+#ifdef CONFIG_MQ_RECEIVE_HANDOFF
+  struct mqueue_rcvbuf_s rcvbuf;
+  FAR struct tcb_s *rtcb;
+#endif
   irqstate_t flags;
   ssize_t ret = 0;
 
@@ -181,7 +186,7 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
   /* Get the message from the message queue */
 
-  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
+  mqmsg = nxmq_remove_queue(msgq);
   if (mqmsg == NULL)
     {
       if ((mq->f_oflags & O_NONBLOCK) != 0)
@@ -190,9 +195,38 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
           return -EAGAIN;
         }
 
+#ifdef CONFIG_MQ_RECEIVE_HANDOFF
+      /* Let a sender copy its message directly to our buffer */
+
+      rcvbuf.msg    = msg;
+      rcvbuf.msglen = msglen;
+      rtcb          = this_task();
+      rtcb->waitbuf = &rcvbuf;
+#endif
+
       /* Wait & get the message from the message queue */
 
       ret = nxmq_wait_receive(msgq, &mqmsg, abstime, ticks);
+
+#ifdef CONFIG_MQ_RECEIVE_HANDOFF
+      if (ret >= 0 && mqmsg == NULL)
+        {
+          /* The message was handed off, it was never counted in the
+           * queue.
+           */
+
+          leave_critical_section(flags);
+          if (prio)
+            {
+              *prio = rcvbuf.priority;
+            }
+
+          return rcvbuf.nbytes;
+        }
+
+      rtcb->waitbuf = NULL;
+#endif
+
       if (ret < 0)
         {
           leave_critical_section(flags);
@@ -208,13 +208,18 @@ static void nxmq_add_queue(FAR struct mqueue_inode_s *msgq,
                            unsigned int prio)
 {
   FAR struct mqueue_msg_s *prev = NULL;
+#ifndef CONFIG_MQ_PRIO_INDEX
   FAR struct mqueue_msg_s *next;
+#endif
 
   /* Insert the new message in the message queue
    * Search the message list to find the location to insert the new
    * message. Each is list is maintained in ascending priority order.
    */
 
+#ifdef CONFIG_MQ_PRIO_INDEX
+  prev = nxmq_index_prev(msgq, mqmsg->priority);
+#else
   list_for_every_entry(&msgq->msglist, next, struct mqueue_msg_s, node)
     {
       if (prio > next->priority)
@@ -226,6 +231,7 @@ static void nxmq_add_queue(FAR struct mqueue_inode_s *msgq,
           prev = next;
         }
     }
+#endif
 
   /* Add the message at the right place */
 
@@ -237,6 +243,10 @@ static void nxmq_add_queue(FAR struct mqueue_inode_s *msgq,
     {
       list_add_head(&msgq->msglist, &mqmsg->node);
     }
+
+#ifdef CONFIG_MQ_PRIO_INDEX
+  nxmq_index_add(msgq, mqmsg);
+#endif
 }
 
 /****************************************************************************
@@ -306,6 +316,24 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_RECEIVE_HANDOFF
+  /* If a receiver is already waiting, the message can be copied straight
+   * into its buffer without going through the queue.
+   */
+
+  if (msgq->cmn.nwaitnotempty > 0)
+    {
+      flags = enter_critical_section();
+      if (nxmq_handoff_send(msgq, msg, msglen, prio))
+        {
+          leave_critical_section(flags);
+          return OK;
+        }
+
+      leave_critical_section(flags);
+    }
+#endif
+
   /* Pre-allocate a message structure */
 
   mqmsg = nxmq_alloc_msg(msglen);
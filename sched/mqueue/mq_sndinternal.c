@@ -92,6 +92,64 @@ static void nxmq_sndtimeout(wdparm_t arg)
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: nxmq_wake_receiver
+ *
+ * Description:
+ *   Wake up the highest priority task that is waiting for the message
+ *   queue to become non-empty.
+ *
+ * Input Parameters:
+ *   msgq   - Message queue descriptor
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions/restrictions:
+ * - Executes within a critical section established by the caller.
+ * - At least one task is waiting for the message queue to be non-empty.
+ *
+ ****************************************************************************/
+
+static void nxmq_wake_receiver(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  FAR struct tcb_s *btcb;
+
+  /* Find the highest priority task that is waiting for
+   * this queue to be non-empty in waitfornotempty
+   * list. leave_critical_section() should give us sufficient
+   * protection since interrupts should never cause a change
+   * in this list
+   */
+
+  btcb = (FAR struct tcb_s *)dq_remfirst(MQ_WNELIST(msgq->cmn));
+
+  /* If one was found, unblock it */
+
+  DEBUGASSERT(btcb);
+
+  if (WDOG_ISACTIVE(&btcb->waitdog))
+    {
+      wd_cancel(&btcb->waitdog);
+    }
+
+  msgq->cmn.nwaitnotempty--;
+
+  /* Indicate that the wait is over. */
+
+  btcb->waitobj = NULL;
+
+  /* Add the task to ready-to-run task list and
+   * perform the context switch if one is needed
+   */
+
+  if (nxsched_add_readytorun(btcb))
+    {
+      up_switch_context(btcb, rtcb);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -238,8 +296,6 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
 
 void nxmq_notify_send(FAR struct mqueue_inode_s *msgq)
 {
-  FAR struct tcb_s *btcb;
-
   /* Check if we need to notify any tasks that are attached to the
    * message queue
    */
@@ -271,39 +327,66 @@ void nxmq_notify_send(FAR struct mqueue_inode_s *msgq)
 
   if (msgq->cmn.nwaitnotempty > 0)
     {
-      FAR struct tcb_s *rtcb = this_task();
-
-      /* Find the highest priority task that is waiting for
-       * this queue to be non-empty in waitfornotempty
-       * list. leave_critical_section() should give us sufficient
-       * protection since interrupts should never cause a change
-       * in this list
-       */
-
-      btcb = (FAR struct tcb_s *)dq_remfirst(MQ_WNELIST(msgq->cmn));
-
-      /* If one was found, unblock it */
+      nxmq_wake_receiver(msgq);
+    }
+}
 
-      DEBUGASSERT(btcb);
+#ifdef CONFIG_MQ_RECEIVE_HANDOFF
+/****************************************************************************
+ * Name: nxmq_handoff_send
+ *
+ * Description:
+ *   Copy a message directly into the buffer of the highest priority task
+ *   waiting for the message queue to become non-empty, and wake that task
+ *   up.  The message does not enter the queue, so no message structure is
+ *   needed and the receiver does not copy it again.
+ *
+ *   Per POSIX, a message that satisfies a waiting mq_receive() does not
+ *   cause an mq_notify() notification.
+ *
+ * Input Parameters:
+ *   msgq   - Message queue descriptor
+ *   msg    - Message to send
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   True if the message was handed off.  False if no receiver is waiting,
+ *   if older messages are still queued, or if the buffer of the receiver
+ *   is too small; the message must then be queued as usual.
+ *
+ * Assumptions/restrictions:
+ * - Executes within a critical section established by the caller.
+ *
+ ****************************************************************************/
 
-      if (WDOG_ISACTIVE(&btcb->waitdog))
-        {
-          wd_cancel(&btcb->waitdog);
-        }
+bool nxmq_handoff_send(FAR struct mqueue_inode_s *msgq,
+                       FAR const char *msg, size_t msglen,
+                       unsigned int prio)
+{
+  FAR struct mqueue_rcvbuf_s *rcvbuf;
+  FAR struct tcb_s *btcb;
 
-      msgq->cmn.nwaitnotempty--;
+  if (msgq->cmn.nwaitnotempty <= 0 || !list_is_empty(&msgq->msglist))
+    {
+      return false;
+    }
 
-      /* Indicate that the wait is over. */
+  btcb   = (FAR struct tcb_s *)dq_peek(MQ_WNELIST(msgq->cmn));
+  rcvbuf = btcb->waitbuf;
+  if (rcvbuf == NULL || rcvbuf->msglen < msglen)
+    {
+      return false;
+    }
 
-      btcb->waitobj = NULL;
+  memcpy(rcvbuf->msg, msg, msglen);
+  rcvbuf->nbytes   = msglen;
+  rcvbuf->priority = prio;
 
-      /* Add the task to ready-to-run task list and
-       * perform the context switch if one is needed
-       */
+  /* Tell the receiver that it got the message */
 
-      if (nxsched_add_readytorun(btcb))
-        {
-          up_switch_context(btcb, rtcb);
-        }
-    }
+  btcb->waitbuf = NULL;
+  nxmq_wake_receiver(msgq);
+  return true;
 }
+#endif
@@ -36,6 +36,7 @@
 #include <limits.h>
 #include <mqueue.h>
 #include <sched.h>
+#include <strings.h>
 
 #include <nuttx/spinlock.h>
 #include <nuttx/mqueue.h>
@@ -78,6 +79,22 @@ struct mqueue_msg_s
   char mail[1];            /* Message data */
 };
 
+#ifdef CONFIG_MQ_RECEIVE_HANDOFF
+/* This structure describes the buffer of a task blocked in mq_receive().
+ * The waitbuf field of the TCB refers to it while the task waits.  A
+ * sender may copy its message directly into the buffer, in which case it
+ * clears waitbuf before waking the task up.
+ */
+
+struct mqueue_rcvbuf_s
+{
+  FAR char *msg;           /* Receive buffer */
+  size_t msglen;           /* Size of the receive buffer */
+  size_t nbytes;           /* Length of the message received */
+  unsigned int priority;   /* Priority of the message received */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -137,6 +154,11 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
                    FAR const struct timespec *abstime,
                    sclock_t ticks);
 void nxmq_notify_send(FAR struct mqueue_inode_s *msgq);
+#ifdef CONFIG_MQ_RECEIVE_HANDOFF
+bool nxmq_handoff_send(FAR struct mqueue_inode_s *msgq,
+                       FAR const char *msg, size_t msglen,
+                       unsigned int prio);
+#endif
 
 /* mq_recover.c *************************************************************/
 
@@ -147,5 +169,107 @@ void nxmq_recover(FAR struct tcb_s *tcb);
 }
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_PRIO_INDEX
+/****************************************************************************
+ * Name: nxmq_index_add
+ *
+ * Description:
+ *   Record that mqmsg is now the last message of its priority in the
+ *   message list.  This must be called after mqmsg has been linked into
+ *   the list behind all other messages of the same priority.
+ *
+ ****************************************************************************/
+
+static inline_function void nxmq_index_add(FAR struct mqueue_inode_s *msgq,
+                                           FAR struct mqueue_msg_s *mqmsg)
+{
+  uint8_t prio = mqmsg->priority;
+
+  msgq->index.tail[prio]       = mqmsg;
+  msgq->index.map[prio >> 5]  |= 1u << (prio & 31);
+  msgq->index.summary         |= 1u << (prio >> 5);
+}
+
+/****************************************************************************
+ * Name: nxmq_index_prev
+ *
+ * Description:
+ *   Return the last message in the message list with a priority greater
+ *   than or equal to prio, or NULL if there is no such message.  A new
+ *   message of priority prio belongs immediately after this message.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct mqueue_msg_s *
+nxmq_index_prev(FAR struct mqueue_inode_s *msgq, unsigned int prio)
+{
+  int word = prio >> 5;
+  uint32_t bits;
+
+  if (msgq->index.tail[prio] != NULL)
+    {
+      return msgq->index.tail[prio];
+    }
+
+  /* Find the lowest non-empty priority above prio: first in the same map
+   * word, then in the next non-zero word.
+   */
+
+  bits = msgq->index.map[word] & ~((2u << (prio & 31)) - 1);
+  if (bits == 0)
+    {
+      bits = msgq->index.summary & ~((2u << word) - 1);
+      if (bits == 0)
+        {
+          return NULL;
+        }
+
+      word = ffs(bits) - 1;
+      bits = msgq->index.map[word];
+    }
+
+  return msgq->index.tail[(word << 5) + ffs(bits) - 1];
+}
+#endif
+
+/****************************************************************************
+ * Name: nxmq_remove_queue
+ *
+ * Description:
+ *   Remove the oldest of the highest priority messages from the message
+ *   list, or return NULL if the list is empty.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct mqueue_msg_s *
+nxmq_remove_queue(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+
+  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
+
+#ifdef CONFIG_MQ_PRIO_INDEX
+  if (mqmsg != NULL && msgq->index.tail[mqmsg->priority] == mqmsg)
+    {
+      uint8_t prio = mqmsg->priority;
+
+      /* mqmsg was the only message of this priority */
+
+      msgq->index.tail[prio]       = NULL;
+      msgq->index.map[prio >> 5]  &= ~(1u << (prio & 31));
+      if (msgq->index.map[prio >> 5] == 0)
+        {
+          msgq->index.summary &= ~(1u << (prio >> 5));
+        }
+    }
+#endif
+
+  return mqmsg;
+}
+
 #endif /* defined(CONFIG_MQ_MAXMSGSIZE) && CONFIG_MQ_MAXMSGSIZE > 0 */
 #endif /* __SCHED_MQUEUE_MQUEUE_H */
@@ -31,6 +31,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <strings.h>
 #include <sched.h>
 
 #include <nuttx/arch.h>
@@ -44,6 +45,13 @@
 
 #define PIDHASH(pid)             ((pid) & (g_npidhash - 1))
 
+/* Geometry of the priority index of the g_readytorun list */
+
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+#  define RTRINDEX_NPRIO         (SCHED_PRIORITY_MAX + 1)
+#  define RTRINDEX_NWORDS        ((RTRINDEX_NPRIO + 31) >> 5)
+#endif
+
 /* The state of a task is indicated both by the task_state field of the TCB
  * and by a series of task lists.  All of these tasks lists are declared
  * below. Although it is not always necessary, most of these lists are
@@ -132,6 +140,21 @@ struct tasklist_s
   uint8_t attr;          /* List attribute flags */
 };
 
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+/* This structure indexes the g_readytorun list by priority.  The list
+ * itself is unchanged; the index only records the last TCB of each
+ * priority present in the list so that the insertion point of a new TCB
+ * can be found with two find-first-set operations instead of a list walk.
+ */
+
+struct rtrindex_s
+{
+  uint32_t summary;                       /* One bit per non-zero map[] word */
+  uint32_t map[RTRINDEX_NWORDS];          /* One bit per non-empty priority */
+  FAR struct tcb_s *tail[RTRINDEX_NPRIO]; /* Last TCB of each priority */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -155,6 +178,15 @@ struct tasklist_s
 
 extern dq_queue_t g_readytorun;
 
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+/* The priority index of the g_readytorun list.  It must be updated
+ * whenever a TCB enters or leaves g_readytorun, or when the priority of a
+ * TCB in g_readytorun is changed in place.
+ */
+
+extern struct rtrindex_s g_rtrindex;
+#endif
+
 #ifdef CONFIG_SMP
 /* In order to support SMP, the function of the g_readytorun list changes,
  * The g_readytorun is still used but in the SMP case it will contain only:
@@ -438,6 +470,148 @@ FAR char **nxsched_get_stackargs(FAR struct tcb_s *tcb);
  * Inline functions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+/****************************************************************************
+ * Name: nxsched_rtrindex_add
+ *
+ * Description:
+ *   Record that tcb is now the last TCB of its priority in g_readytorun.
+ *   This must be called after tcb has been linked into g_readytorun behind
+ *   all other TCBs of the same priority.
+ *
+ ****************************************************************************/
+
+static inline_function void nxsched_rtrindex_add(FAR struct tcb_s *tcb)
+{
+  uint8_t prio = tcb->sched_priority;
+
+  g_rtrindex.tail[prio]       = tcb;
+  g_rtrindex.map[prio >> 5]  |= 1u << (prio & 31);
+  g_rtrindex.summary         |= 1u << (prio >> 5);
+}
+
+/****************************************************************************
+ * Name: nxsched_rtrindex_remove
+ *
+ * Description:
+ *   Drop tcb from the priority index.  This must be called while tcb is
+ *   still linked in g_readytorun, i.e. before it is removed from the list.
+ *
+ ****************************************************************************/
+
+static inline_function void nxsched_rtrindex_remove(FAR struct tcb_s *tcb)
+{
+  uint8_t prio = tcb->sched_priority;
+  FAR struct tcb_s *prev;
+
+  if (g_rtrindex.tail[prio] != tcb)
+    {
+      /* Some other TCB of this priority follows tcb in the list */
+
+      return;
+    }
+
+  prev = tcb->blink;
+  if (prev != NULL && prev->sched_priority == prio)
+    {
+      g_rtrindex.tail[prio] = prev;
+    }
+  else
+    {
+      /* tcb was the only TCB of this priority */
+
+      g_rtrindex.tail[prio]       = NULL;
+      g_rtrindex.map[prio >> 5]  &= ~(1u << (prio & 31));
+      if (g_rtrindex.map[prio >> 5] == 0)
+        {
+          g_rtrindex.summary &= ~(1u << (prio >> 5));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_rtrindex_prev
+ *
+ * Description:
+ *   Return the last TCB in g_readytorun with a priority greater than or
+ *   equal to sched_priority, or NULL if there is no such TCB.  A new TCB
+ *   of priority sched_priority belongs immediately after this TCB.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct tcb_s *
+nxsched_rtrindex_prev(uint8_t sched_priority)
+{
+  int word = sched_priority >> 5;
+  uint32_t bits;
+
+  if (g_rtrindex.tail[sched_priority] != NULL)
+    {
+      return g_rtrindex.tail[sched_priority];
+    }
+
+  /* Find the lowest non-empty priority above sched_priority: first in the
+   * same map word, then in the next non-zero word.
+   */
+
+  bits = g_rtrindex.map[word] & ~((2u << (sched_priority & 31)) - 1);
+  if (bits == 0)
+    {
+      bits = g_rtrindex.summary & ~((2u << word) - 1);
+      if (bits == 0)
+        {
+          return NULL;
+        }
+
+      word = ffs(bits) - 1;
+      bits = g_rtrindex.map[word];
+    }
+
+  return g_rtrindex.tail[(word << 5) + ffs(bits) - 1];
+}
+
+/****************************************************************************
+ * Name: nxsched_rtrindex_setpriority
+ *
+ * Description:
+ *   Change the priority of the running task without moving it in its task
+ *   list.  The caller must assure that the task remains the highest
+ *   priority task of the list.  In the non-SMP case, the running task is
+ *   the head of g_readytorun and the index must follow the change.
+ *
+ ****************************************************************************/
+
+static inline_function void
+nxsched_rtrindex_setpriority(FAR struct tcb_s *tcb, uint8_t sched_priority)
+{
+#ifndef CONFIG_SMP
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      nxsched_rtrindex_remove(tcb);
+      tcb->sched_priority = sched_priority;
+
+      /* tcb is the head of the list, so any other TCB of the same priority
+       * is already the correct tail of this priority.
+       */
+
+      if (g_rtrindex.tail[sched_priority] == NULL)
+        {
+          nxsched_rtrindex_add(tcb);
+        }
+
+      return;
+    }
+#endif
+
+  tcb->sched_priority = sched_priority;
+}
+#else
+#  define nxsched_rtrindex_add(tcb)
+#  define nxsched_rtrindex_remove(tcb)
+#  define nxsched_rtrindex_setpriority(tcb, prio) \
+     ((tcb)->sched_priority = (prio))
+#endif
+
 static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
                                                     DSEG dq_queue_t *list)
 {
@@ -450,13 +624,28 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
 
   DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
-  /* Search the list to find the location to insert the new Tcb.
-   * Each is list is maintained in descending sched_priority order.
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+  /* The g_readytorun list is indexed by priority:  The new TCB goes just
+   * after the last TCB with the same or higher priority.
    */
 
-  for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
-       next = next->flink);
+  if (list == list_readytorun())
+    {
+      prev = nxsched_rtrindex_prev(sched_priority);
+      next = prev != NULL ? prev->flink : (FAR struct tcb_s *)list->head;
+      nxsched_rtrindex_add(tcb);
+    }
+  else
+#endif
+    {
+      /* Search the list to find the location to insert the new Tcb.
+       * Each is list is maintained in descending sched_priority order.
+       */
+
+      for (next = (FAR struct tcb_s *)list->head;
+           (next && sched_priority <= next->sched_priority);
+           next = next->flink);
+    }
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
    * goes at the end of the list. NOTE:  This could only happen if list
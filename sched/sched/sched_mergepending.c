@@ -148,6 +148,10 @@ bool nxsched_merge_pending(void)
               ptcb->task_state  = TSTATE_TASK_READYTORUN;
             }
 
+          /* ptcb is now the last TCB of its priority in the list */
+
+          nxsched_rtrindex_add(ptcb);
+
           /* Set up for the next time through */
 
           rtcb = ptcb;
@@ -28,12 +28,48 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <assert.h>
 
 #include <nuttx/queue.h>
 
 #include "sched/sched.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_rtrindex_rebuild
+ *
+ * Description:
+ *   Rebuild the priority index of the g_readytorun list after it has been
+ *   modified in bulk.  This does nothing if list is any other list.  The
+ *   cost is linear, but so is the merge that precedes it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_READYTORUN_INDEX
+static void nxsched_rtrindex_rebuild(FAR dq_queue_t *list)
+{
+  FAR struct tcb_s *tcb;
+
+  if (list == list_readytorun())
+    {
+      memset(&g_rtrindex, 0, sizeof(g_rtrindex));
+
+      for (tcb  = (FAR struct tcb_s *)dq_peek(list);
+           tcb != NULL;
+           tcb  = (FAR struct tcb_s *)dq_next((FAR dq_entry_t *)tcb))
+        {
+          nxsched_rtrindex_add(tcb);
+        }
+    }
+}
+#else
+#  define nxsched_rtrindex_rebuild(list)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -79,6 +115,7 @@ void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
    */
 
   dq_move(list1, &clone);
+  nxsched_rtrindex_rebuild(list1);
 
   /* Get the TCB at the head of list1 */
 
@@ -110,6 +147,7 @@ void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
       /* Special case.. list2 is empty.  Move list1 to list2. */
 
       dq_move(&clone, list2);
+      nxsched_rtrindex_rebuild(list2);
       return;
     }
 
@@ -159,4 +197,6 @@ void nxsched_merge_prioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
         }
     }
   while (tcb1 != NULL);
+
+  nxsched_rtrindex_rebuild(list2);
 }
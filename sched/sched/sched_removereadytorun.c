@@ -93,6 +93,11 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
+  if (tasklist == list_readytorun())
+    {
+      nxsched_rtrindex_remove(rtcb);
+    }
+
   dq_rem((FAR dq_entry_t *)rtcb, tasklist);
 
   /* Since the TCB is not in any list, it is now invalid */
@@ -253,6 +258,7 @@ void nxsched_remove_running(FAR struct tcb_s *tcb)
        * list and add to the head of the g_assignedtasks[cpu] list.
        */
 
+      nxsched_rtrindex_remove(rtrtcb);
       dq_rem((FAR dq_entry_t *)rtrtcb, &g_readytorun);
       dq_addfirst_nonempty((FAR dq_entry_t *)rtrtcb, tasklist);
 
@@ -318,6 +324,11 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *tcb)
        * g_assignedtasks[cpu] list.
        */
 
+      if (tasklist == list_readytorun())
+        {
+          nxsched_rtrindex_remove(tcb);
+        }
+
       dq_rem((FAR dq_entry_t *)tcb, tasklist);
 
       /* Since the TCB is no longer in any list, it is now invalid */
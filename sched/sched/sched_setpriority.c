@@ -216,7 +216,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
           /* Change the task priority */
 
-          tcb->sched_priority = (uint8_t)sched_priority;
+          nxsched_rtrindex_setpriority(tcb, (uint8_t)sched_priority);
         }
       else
         {
@@ -261,7 +261,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
     {
       /* Change the task priority */
 
-      tcb->sched_priority = (uint8_t)sched_priority;
+      nxsched_rtrindex_setpriority(tcb, (uint8_t)sched_priority);
     }
 }
 
@@ -80,11 +80,11 @@ int wd_cancel(FAR struct wdog_s *wdog)
    * cancellation is complete
    */
 
-  head = list_is_head(&g_wdactivelist, &wdog->node);
+  head = wd_isfirst(wdog);
 
   /* Now, remove the watchdog from the timer queue */
 
-  list_delete(&wdog->node);
+  wd_dequeue(wdog);
 
   /* Mark the watchdog inactive */
 
@@ -36,12 +36,14 @@
 
 spinlock_t g_wdspinlock = SP_UNLOCKED;
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -167,10 +167,8 @@ static inline_function void wd_expiration(clock_t ticks)
    * other watchdogs that became ready to run at this time
    */
 
-  while (!list_is_empty(&g_wdactivelist))
+  while ((wdog = wd_first()) != NULL)
     {
-      wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
-
       /* Check if expected time is expired */
 
       if (!clock_compare(wdog->expired, ticks))
@@ -178,9 +176,17 @@ static inline_function void wd_expiration(clock_t ticks)
           break;
         }
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+      /* Cascade the slot of the watchdog so that it and all watchdogs
+       * expiring at the same time are found in constant time.
+       */
+
+      wd_wheel_advance(wdog->expired);
+#endif
+
       /* Remove the watchdog from the head of the list */
 
-      list_delete(&wdog->node);
+      wd_dequeue(wdog);
 
       /* Indicate that the watchdog is no longer active. */
 
@@ -200,6 +206,14 @@ static inline_function void wd_expiration(clock_t ticks)
       flags = spin_lock_irqsave(&g_wdspinlock);
     }
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  /* Keep the wheel close to the current time so that new watchdogs are
+   * placed at the lowest possible level.
+   */
+
+  wd_wheel_advance(ticks);
+#endif
+
 #ifdef CONFIG_SCHED_TICKLESS
   /* Decrement the nested watchdog timer count */
 
@@ -214,7 +228,8 @@ static inline_function void wd_expiration(clock_t ticks)
  *
  * Description:
  *   Insert the timer into the global list to ensure that
- *   the list is sorted in increasing order of expiration absolute time.
+ *   the list is sorted in increasing order of expiration absolute time,
+ *   or into the timer wheel if CONFIG_WDOG_TIMER_WHEEL is selected.
  *
  * Input Parameters:
  *   wdog     - Watchdog ID
@@ -234,6 +249,14 @@ static inline_function
 void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+  wd_wheel_insert(wdog);
+#else
   FAR struct wdog_s *curr;
 
   /* Traverse the watchdog list */
@@ -261,6 +284,7 @@ void wd_insert(FAR struct wdog_s *wdog, clock_t expired,
   up_getpicbase(&wdog->picbase);
   wdog->arg = arg;
   wdog->expired = expired;
+#endif
 }
 
 /****************************************************************************
@@ -344,15 +368,14 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
   if (WDOG_ISACTIVE(wdog))
     {
-      reassess |= list_is_head(&g_wdactivelist, &wdog->node);
-      list_delete(&wdog->node);
+      reassess |= wd_isfirst(wdog);
+      wd_dequeue(wdog);
       wdog->func = NULL;
     }
 
   wd_insert(wdog, ticks, wdentry, arg);
 
-  if (!g_wdtimernested &&
-      (reassess || list_is_head(&g_wdactivelist, &wdog->node)))
+  if (!g_wdtimernested && (reassess || wd_isfirst(wdog)))
     {
       /* Resume the interval timer that will generate the next
        * interval event. If the timer at the head of the list changed,
@@ -373,7 +396,7 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
   if (WDOG_ISACTIVE(wdog))
     {
-      list_delete(&wdog->node);
+      wd_dequeue(wdog);
       wdog->func = NULL;
     }
 
@@ -518,7 +541,8 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
 
   /* Return the delay for the next watchdog to expire */
 
-  if (list_is_empty(&g_wdactivelist))
+  wdog = wd_first();
+  if (wdog == NULL)
     {
       spin_unlock_irqrestore(&g_wdspinlock, flags);
       return 0;
@@ -528,7 +552,6 @@ clock_t wd_timer(clock_t ticks, bool noswitches)
    * may get negative value.
    */
 
-  wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
   ret = wdog->expired - ticks;
 
   spin_unlock_irqrestore(&g_wdspinlock, flags);
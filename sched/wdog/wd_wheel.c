@@ -0,0 +1,446 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <strings.h>
+
+#include <nuttx/clock.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The wheel consists of WHEEL_LEVELS levels of WHEEL_SIZE slots each.  A
+ * slot at level 'l' covers 2^(l * WHEEL_BITS) ticks.
+ *
+ * A watchdog is kept at the lowest level 'l' such that its expiration time
+ * and g_wdbase only differ in the bit group 'l', in the slot selected by
+ * that bit group of the expiration time.  Hence every occupied slot of a
+ * level lies ahead of the slot of g_wdbase at that level, and every
+ * watchdog at a level expires before any watchdog at a higher level.
+ * Watchdogs that expire before or at g_wdbase are kept in the level 0 slot
+ * of g_wdbase.  Watchdogs that differ from g_wdbase above the highest
+ * level are kept unsorted in g_wdfarlist.
+ *
+ * When g_wdbase advances, the slots that it reaches are emptied and their
+ * watchdogs are placed again relative to the new g_wdbase ("cascaded").
+ * Expiration times are kept exact; a watchdog is never fired early or late
+ * because of the slot granularity.
+ */
+
+#define WHEEL_BITS          6
+#define WHEEL_SIZE          (1 << WHEEL_BITS)
+#define WHEEL_MASK          (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS        CONFIG_WDOG_TIMER_WHEEL_LEVELS
+
+#define WHEEL_SHIFT(l)      ((l) * WHEEL_BITS)
+#define WHEEL_INDEX(t, l)   ((unsigned int)((t) >> WHEEL_SHIFT(l)) & WHEEL_MASK)
+#define WHEEL_BLOCK(t, l)   ((t) >> WHEEL_SHIFT((l) + 1))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The slot lists.  A slot list is only valid while the corresponding bit
+ * of g_wdwheelmap[] is set; it is (re-)initialized when it is first used.
+ */
+
+static struct list_node g_wdwheel[WHEEL_LEVELS][WHEEL_SIZE];
+
+/* One bit per non-empty slot of each level */
+
+static uint64_t g_wdwheelmap[WHEEL_LEVELS];
+
+/* Watchdogs beyond the reach of the highest level */
+
+static struct list_node g_wdfarlist = LIST_INITIAL_VALUE(g_wdfarlist);
+
+/* The time that the wheel is positioned at */
+
+static clock_t g_wdbase;
+
+/* The active watchdog that expires first, or NULL if there is none.  This
+ * is kept up to date on insertion.  When it is removed, g_wdstale is set
+ * and the next one is only searched for by wd_wheel_first().
+ */
+
+static FAR struct wdog_s *g_wdearliest;
+static bool g_wdstale;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_locate
+ *
+ * Description:
+ *   Return the level and slot index where a watchdog expiring at 'expired'
+ *   belongs, given the current g_wdbase.  A level of WHEEL_LEVELS selects
+ *   g_wdfarlist.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_locate(clock_t expired, FAR unsigned int *index)
+{
+  int level;
+
+  if (clock_compare(expired, g_wdbase))
+    {
+      /* Already expired */
+
+      *index = WHEEL_INDEX(g_wdbase, 0);
+      return 0;
+    }
+
+  level = (flsll((long long)(expired ^ g_wdbase)) - 1) / WHEEL_BITS;
+  if (level >= WHEEL_LEVELS)
+    {
+      return WHEEL_LEVELS;
+    }
+
+  *index = WHEEL_INDEX(expired, level);
+  return level;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_earliest
+ *
+ * Description:
+ *   Return the watchdog with the earliest expiration time in a non-empty,
+ *   unsorted list.
+ *
+ ****************************************************************************/
+
+static FAR struct wdog_s *wd_wheel_earliest(FAR struct list_node *list)
+{
+  FAR struct wdog_s *earliest = NULL;
+  FAR struct wdog_s *curr;
+
+  list_for_every_entry(list, curr, struct wdog_s, node)
+    {
+      if (earliest == NULL || !clock_compare(earliest->expired,
+                                             curr->expired))
+        {
+          earliest = curr;
+        }
+    }
+
+  return earliest;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_place
+ *
+ * Description:
+ *   Put an active watchdog in the slot where it belongs.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_place(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *slot;
+  unsigned int index;
+  int level;
+
+  level = wd_wheel_locate(wdog->expired, &index);
+  if (level == WHEEL_LEVELS)
+    {
+      list_add_tail(&g_wdfarlist, &wdog->node);
+      return;
+    }
+
+  slot = &g_wdwheel[level][index];
+  if ((g_wdwheelmap[level] & (UINT64_C(1) << index)) == 0)
+    {
+      list_initialize(slot);
+      g_wdwheelmap[level] |= UINT64_C(1) << index;
+    }
+
+  list_add_tail(slot, &wdog->node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_isempty
+ *
+ * Description:
+ *   Return true if there is no active watchdog.
+ *
+ ****************************************************************************/
+
+static bool wd_wheel_isempty(void)
+{
+  int level;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      if (g_wdwheelmap[level] != 0)
+        {
+          return false;
+        }
+    }
+
+  return list_is_empty(&g_wdfarlist);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add an active watchdog to the timer wheel.  wdog->expired must already
+ *   be set.  Watchdogs of the same expiration time expire in the order they
+ *   were inserted.
+ *
+ * Assumptions:
+ *   The caller holds g_wdspinlock.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  /* The wheel is only advanced when watchdogs expire.  If it has been
+   * empty for a while, bring it to the current time first so that the new
+   * watchdog is not mistaken for an expired one after a tick wrap-around.
+   */
+
+  if (wd_wheel_isempty())
+    {
+      g_wdbase     = clock_systime_ticks();
+      g_wdearliest = NULL;
+      g_wdstale    = false;
+    }
+
+  wd_wheel_place(wdog);
+
+  /* Watchdogs of the same expiration time expire in insertion order, so
+   * only a strictly earlier one replaces the cached first watchdog.
+   */
+
+  if (!g_wdstale && (g_wdearliest == NULL ||
+                     !clock_compare(g_wdearliest->expired, wdog->expired)))
+    {
+      g_wdearliest = wdog;
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_delete
+ *
+ * Description:
+ *   Remove an active watchdog from the timer wheel.
+ *
+ * Assumptions:
+ *   The caller holds g_wdspinlock.
+ *
+ ****************************************************************************/
+
+void wd_wheel_delete(FAR struct wdog_s *wdog)
+{
+  unsigned int index;
+  int level;
+
+  level = wd_wheel_locate(wdog->expired, &index);
+  list_delete(&wdog->node);
+
+  if (level < WHEEL_LEVELS && list_is_empty(&g_wdwheel[level][index]))
+    {
+      g_wdwheelmap[level] &= ~(UINT64_C(1) << index);
+    }
+
+  if (wdog == g_wdearliest)
+    {
+      g_wdearliest = NULL;
+      g_wdstale    = !wd_wheel_isempty();
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_first
+ *
+ * Description:
+ *   Return the active watchdog that expires first, or NULL if there is no
+ *   active watchdog.  This is constant time unless the first watchdog was
+ *   removed since the last call and the next one is in the slot of
+ *   g_wdbase or beyond the lowest level; then the slot holding it is
+ *   searched.
+ *
+ * Assumptions:
+ *   The caller holds g_wdspinlock.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_first(void)
+{
+  FAR struct list_node *slot;
+  unsigned int index;
+  int level;
+
+  if (!g_wdstale)
+    {
+      return g_wdearliest;
+    }
+
+  g_wdstale = false;
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      if (g_wdwheelmap[level] != 0)
+        {
+          index = ffsll(g_wdwheelmap[level]) - 1;
+          slot  = &g_wdwheel[level][index];
+
+          /* All watchdogs in a level 0 slot expire at the same tick,
+           * except in the slot of g_wdbase, which also holds the
+           * watchdogs that had already expired when they were placed.
+           */
+
+          if (level == 0 && index != WHEEL_INDEX(g_wdbase, 0))
+            {
+              g_wdearliest = list_first_entry(slot, struct wdog_s, node);
+            }
+          else
+            {
+              g_wdearliest = wd_wheel_earliest(slot);
+            }
+
+          return g_wdearliest;
+        }
+    }
+
+  g_wdearliest = wd_wheel_earliest(&g_wdfarlist);
+  return g_wdearliest;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_isfirst
+ *
+ * Description:
+ *   Return true if 'wdog' is the active watchdog that expires first, in
+ *   constant time.  This is also true if the first watchdog was removed
+ *   and the next one was not searched for yet:  The timer was then set up
+ *   for a watchdog that is gone and needs to be reassessed anyway.
+ *
+ * Assumptions:
+ *   The caller holds g_wdspinlock.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_isfirst(FAR struct wdog_s *wdog)
+{
+  return g_wdstale || g_wdearliest == wdog;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Move the wheel forward to 'ticks', cascading every slot that is reached
+ *   on the way.  Watchdogs that expire at or before 'ticks' end up in the
+ *   level 0 slot of 'ticks'.  This does nothing if 'ticks' is not after the
+ *   current position of the wheel.
+ *
+ * Assumptions:
+ *   The caller holds g_wdspinlock.
+ *
+ ****************************************************************************/
+
+void wd_wheel_advance(clock_t ticks)
+{
+  struct list_node pending;
+  FAR struct wdog_s *wdog;
+  FAR struct wdog_s *tmp;
+  FAR struct list_node *slot;
+  uint64_t mask;
+  unsigned int index;
+  int level;
+
+  if (clock_compare(ticks, g_wdbase))
+    {
+      return;
+    }
+
+  list_initialize(&pending);
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      /* Within the same block of the next level, only the slots up to the
+       * new position are reached.  Otherwise, the whole level is.
+       */
+
+      mask = g_wdwheelmap[level];
+      if (WHEEL_BLOCK(ticks, level) == WHEEL_BLOCK(g_wdbase, level))
+        {
+          mask &= (UINT64_C(2) << WHEEL_INDEX(ticks, level)) - 1;
+        }
+
+      g_wdwheelmap[level] &= ~mask;
+
+      while (mask != 0)
+        {
+          index = ffsll(mask) - 1;
+          mask &= mask - 1;
+
+          slot = &g_wdwheel[level][index];
+          list_for_every_entry_safe(slot, wdog, tmp, struct wdog_s, node)
+            {
+              list_delete(&wdog->node);
+              list_add_tail(&pending, &wdog->node);
+            }
+        }
+    }
+
+  if (WHEEL_BLOCK(ticks, WHEEL_LEVELS - 1) !=
+      WHEEL_BLOCK(g_wdbase, WHEEL_LEVELS - 1))
+    {
+      list_for_every_entry_safe(&g_wdfarlist, wdog, tmp,
+                                struct wdog_s, node)
+        {
+          list_delete(&wdog->node);
+          list_add_tail(&pending, &wdog->node);
+        }
+    }
+
+  g_wdbase = ticks;
+
+  list_for_every_entry_safe(&pending, wdog, tmp, struct wdog_s, node)
+    {
+      list_delete(&wdog->node);
+      wd_wheel_place(wdog);
+    }
+}
+
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
@@ -47,6 +47,25 @@
 
 #define list_node wdlist_node
 
+/* Access to the queue of active watchdogs, whichever its implementation.
+ * wd_first() returns the active watchdog that expires first (or NULL),
+ * wd_isfirst() tells whether the timer must be reassessed when a watchdog
+ * is queued or dequeued and wd_dequeue() removes an active watchdog from
+ * the queue.
+ */
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#  define wd_first()        wd_wheel_first()
+#  define wd_isfirst(wdog)  wd_wheel_isfirst(wdog)
+#  define wd_dequeue(wdog)  wd_wheel_delete(wdog)
+#else
+#  define wd_first() \
+     (list_is_empty(&g_wdactivelist) ? NULL : \
+      list_first_entry(&g_wdactivelist, struct wdog_s, node))
+#  define wd_isfirst(wdog)  (wd_first() == (wdog))
+#  define wd_dequeue(wdog)  list_delete(&(wdog)->node)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -59,12 +78,15 @@ extern "C"
 #define EXTERN extern
 #endif
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern struct list_node g_wdactivelist;
+#endif
+
 extern spinlock_t g_wdspinlock;
 
 /****************************************************************************
@@ -125,6 +147,29 @@ void wd_timer(clock_t ticks);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_wheel_insert, wd_wheel_delete, wd_wheel_first,
+ *       wd_wheel_isfirst, wd_wheel_advance
+ *
+ * Description:
+ *   Timer wheel implementation of the queue of active watchdogs:  Insert
+ *   and remove a watchdog, return the watchdog that expires first, check
+ *   whether a watchdog is that one and move the wheel forward to the
+ *   current time.
+ *
+ * Assumptions:
+ *   The caller holds g_wdspinlock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+void wd_wheel_insert(FAR struct wdog_s *wdog);
+void wd_wheel_delete(FAR struct wdog_s *wdog);
+FAR struct wdog_s *wd_wheel_first(void);
+bool wd_wheel_isfirst(FAR struct wdog_s *wdog);
+void wd_wheel_advance(clock_t ticks);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
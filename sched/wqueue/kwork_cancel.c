@@ -58,7 +58,7 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
    * new work is typically added to the work queue from interrupt handlers.
    */
 
-  flags = spin_lock_irqsave(&wqueue->lock);
+  flags = work_lock(wqueue, work);
   if (work->worker != NULL)
     {
       /* Remove the entry from the work queue and make sure that it is
@@ -67,10 +67,7 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
 
       work->worker = NULL;
       wd_cancel(&work->u.timer);
-      if (dq_inqueue((FAR dq_entry_t *)work, &wqueue->q))
-        {
-          dq_rem((FAR dq_entry_t *)work, &wqueue->q);
-        }
+      work_dequeue(wqueue, work);
 
       ret = OK;
     }
@@ -84,14 +81,14 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
               wqueue->worker[wndx].pid != nxsched_gettid())
             {
               wqueue->worker[wndx].wait_count++;
-              spin_unlock_irqrestore(&wqueue->lock, flags);
+              work_unlock(wqueue, work, flags);
               nxsem_wait_uninterruptible(&wqueue->worker[wndx].wait);
               return 1;
             }
         }
     }
 
-  spin_unlock_irqrestore(&wqueue->lock, flags);
+  work_unlock(wqueue, work, flags);
   return ret;
 }
 
@@ -36,30 +36,136 @@
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
 
+#include "sched/sched.h"
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Private Functions
  ****************************************************************************/
 
-#define queue_work(wqueue, work) \
-  do \
-    { \
-      dq_addlast((FAR dq_entry_t *)(work), &(wqueue)->q); \
-      if ((wqueue)->wait_count > 0) /* There are threads waiting for sem. */ \
-        { \
-          (wqueue)->wait_count--; \
-          nxsem_post(&(wqueue)->sem); \
-        } \
-    } \
-  while (0)
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+/****************************************************************************
+ * Name: work_trywake
+ *
+ * Description:
+ *   Wake up a worker if it is idle.  Returns true if it was woken up.
+ *
+ ****************************************************************************/
+
+static bool work_trywake(FAR struct kworker_s *kworker)
+{
+  bool idle;
+
+  if (!kworker->idle)
+    {
+      return false;
+    }
+
+  spin_lock(&kworker->qlock);
+  idle = kworker->idle;
+  if (idle)
+    {
+      kworker->idle = false;
+      nxsem_post(&kworker->sem);
+    }
+
+  spin_unlock(&kworker->qlock);
+  return idle;
+}
 
 /****************************************************************************
- * Private Functions
+ * Name: work_wakeup
+ *
+ * Description:
+ *   Wake up a worker for the work just queued to the worker 'local'.  An
+ *   idle worker whose CPU is not running anything more important is
+ *   preferred, starting with 'local', since it can start the work at once.
+ *   Otherwise any idle worker is woken up.  If no worker is idle, the work
+ *   is taken by the first worker that completes its current work.
+ *
  ****************************************************************************/
 
+static void work_wakeup(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct kworker_s *local)
+{
+  FAR struct kworker_s *kworker;
+  int self = local - wqueue->worker;
+  int wndx;
+  int i;
+
+  for (i = 0; i < wqueue->nthreads; i++)
+    {
+      wndx    = (self + i) % wqueue->nthreads;
+      kworker = &wqueue->worker[wndx];
+      if (current_task(wndx % CONFIG_SMP_NCPUS)->sched_priority <
+          kworker->tcb->sched_priority && work_trywake(kworker))
+        {
+          return;
+        }
+    }
+
+  for (i = 0; i < wqueue->nthreads; i++)
+    {
+      if (work_trywake(&wqueue->worker[(self + i) % wqueue->nthreads]))
+        {
+          return;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: queue_work
+ *
+ * Description:
+ *   Put the work on the pending list and wake up a worker for it.  The
+ *   caller holds the lock of the work.
+ *
+ ****************************************************************************/
+
+static void queue_work(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct work_s *work)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  FAR struct kworker_s *kworker;
+#endif
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  work->stime = perf_gettime();
+#endif
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  /* Queue the work to the worker of this CPU so that it runs where its
+   * data is cache-hot.  If that worker cannot run it soon, another worker
+   * is woken up and steals the work.
+   */
+
+  kworker = &wqueue->worker[this_cpu() % wqueue->nthreads];
+
+  spin_lock(&kworker->qlock);
+  dq_addlast((FAR dq_entry_t *)work, &kworker->q);
+  work->pending = &kworker->q;
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  kworker->stats.nqueued++;
+#endif
+  spin_unlock(&kworker->qlock);
+
+  work_wakeup(wqueue, kworker);
+#else
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  wqueue->stats.nqueued++;
+#endif
+  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+  if (wqueue->wait_count > 0) /* There are threads waiting for sem. */
+    {
+      wqueue->wait_count--;
+      nxsem_post(&wqueue->sem);
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: work_timer_expiry
  ****************************************************************************/
@@ -68,7 +174,7 @@ static void work_timer_expiry(wdparm_t arg)
 {
   FAR struct work_s *work = (FAR struct work_s *)arg;
 
-  irqstate_t flags = spin_lock_irqsave(&work->wq->lock);
+  irqstate_t flags = work_lock(work->wq, work);
   sched_lock();
 
   /* We have being canceled */
@@ -78,7 +184,7 @@ static void work_timer_expiry(wdparm_t arg)
       queue_work(work->wq, work);
     }
 
-  spin_unlock_irqrestore(&work->wq->lock, flags);
+  work_unlock(work->wq, work, flags);
   sched_unlock();
 }
 
@@ -152,7 +258,7 @@ int work_queue_period_wq(FAR struct kwork_wqueue_s *wqueue,
    * task logic or from interrupt handling logic.
    */
 
-  flags = spin_lock_irqsave(&wqueue->lock);
+  flags = work_lock(wqueue, work);
   sched_lock();
 
   /* Remove the entry from the timer and work queue. */
@@ -165,10 +271,7 @@ int work_queue_period_wq(FAR struct kwork_wqueue_s *wqueue,
 
       work->worker = NULL;
       wd_cancel(&work->u.timer);
-      if (dq_inqueue((FAR dq_entry_t *)work, &wqueue->q))
-        {
-          dq_rem((FAR dq_entry_t *)work, &wqueue->q);
-        }
+      work_dequeue(wqueue, work);
     }
 
   if (work_is_canceling(wqueue->worker, wqueue->nthreads, work))
@@ -200,7 +303,7 @@ int work_queue_period_wq(FAR struct kwork_wqueue_s *wqueue,
     }
 
 out:
-  spin_unlock_irqrestore(&wqueue->lock, flags);
+  work_unlock(wqueue, work, flags);
   sched_unlock();
   return ret;
 }
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <unistd.h>
 #include <sched.h>
 #include <stdio.h>
@@ -110,6 +111,190 @@ struct lp_wqueue_s g_lpwork =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_take
+ *
+ * Description:
+ *   Remove the oldest work pending on a worker.  The lock of a work must be
+ *   taken before the lock of the list, so the head of the list is looked up
+ *   first and only used once it is known to be still there.
+ *
+ * Returned Value:
+ *   The work with its lock held, or NULL if nothing is pending.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+static FAR struct work_s *work_take(FAR struct kwork_wqueue_s *wqueue,
+                                    FAR struct kworker_s *kworker,
+                                    FAR irqstate_t *flags)
+{
+  FAR struct work_s *work;
+
+  for (; ; )
+    {
+      *flags = spin_lock_irqsave(&kworker->qlock);
+      work = (FAR struct work_s *)dq_peek(&kworker->q);
+      spin_unlock_irqrestore(&kworker->qlock, *flags);
+
+      if (work == NULL)
+        {
+          return NULL;
+        }
+
+      *flags = work_lock(wqueue, work);
+      spin_lock(&kworker->qlock);
+      if ((FAR struct work_s *)dq_peek(&kworker->q) == work)
+        {
+          dq_rem((FAR dq_entry_t *)work, &kworker->q);
+          work->pending = NULL;
+          spin_unlock(&kworker->qlock);
+          return work;
+        }
+
+      spin_unlock(&kworker->qlock);
+      work_unlock(wqueue, work, *flags);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: work_pick
+ *
+ * Description:
+ *   Take the next work for a worker: the oldest work pending on the worker
+ *   itself or, if there is none, the oldest work pending on one of the
+ *   other workers.
+ *
+ * Returned Value:
+ *   The work with its lock held.  If there is no work, NULL is returned
+ *   with the lock held that work_idle() releases.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+static FAR struct work_s *work_pick(FAR struct kwork_wqueue_s *wqueue,
+                                    FAR struct kworker_s *kworker,
+                                    FAR irqstate_t *flags)
+{
+  FAR struct work_s *work;
+  int self = kworker - wqueue->worker;
+  int i;
+
+  for (; ; )
+    {
+      for (i = 0; i < wqueue->nthreads; i++)
+        {
+          work = work_take(wqueue,
+                           &wqueue->worker[(self + i) % wqueue->nthreads],
+                           flags);
+          if (work != NULL)
+            {
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+              if (i > 0)
+                {
+                  spin_lock(&kworker->qlock);
+                  kworker->stats.nstolen++;
+                  spin_unlock(&kworker->qlock);
+                }
+#endif
+
+              return work;
+            }
+        }
+
+      /* Work queued to this worker after it was looked at must not be
+       * left behind when the worker goes idle.
+       */
+
+      *flags = spin_lock_irqsave(&kworker->qlock);
+      if (dq_empty(&kworker->q))
+        {
+          return NULL;
+        }
+
+      spin_unlock_irqrestore(&kworker->qlock, *flags);
+    }
+}
+#else
+static FAR struct work_s *work_pick(FAR struct kwork_wqueue_s *wqueue,
+                                    FAR struct kworker_s *kworker,
+                                    FAR irqstate_t *flags)
+{
+  *flags = spin_lock_irqsave(&wqueue->lock);
+  return (FAR struct work_s *)dq_remfirst(&wqueue->q);
+}
+#endif
+
+/****************************************************************************
+ * Name: work_idle
+ *
+ * Description:
+ *   Wait for new work after work_pick() found none.  The lock returned by
+ *   work_pick() is released before waiting.
+ *
+ ****************************************************************************/
+
+static void work_idle(FAR struct kwork_wqueue_s *wqueue,
+                      FAR struct kworker_s *kworker, irqstate_t flags)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  kworker->idle = true;
+  spin_unlock_irqrestore(&kworker->qlock, flags);
+  sched_unlock();
+
+  nxsem_wait_uninterruptible(&kworker->sem);
+#else
+  wqueue->wait_count++;
+  spin_unlock_irqrestore(&wqueue->lock, flags);
+  sched_unlock();
+
+  nxsem_wait_uninterruptible(&wqueue->sem);
+#endif
+}
+
+/****************************************************************************
+ * Name: work_account
+ *
+ * Description:
+ *   Account a completed work in the statistics.  The caller holds the lock
+ *   of the work.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+static void work_account(FAR struct kwork_wqueue_s *wqueue,
+                         FAR struct kworker_s *kworker,
+                         clock_t wait, clock_t run)
+{
+  FAR struct work_stats_s *stats;
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  spin_lock(&kworker->qlock);
+  stats = &kworker->stats;
+#else
+  stats = &wqueue->stats;
+#endif
+
+  stats->ndone++;
+  stats->totalwait += wait;
+  if (wait > stats->maxwait)
+    {
+      stats->maxwait = wait;
+    }
+
+  stats->totalrun += run;
+  if (run > stats->maxrun)
+    {
+      stats->maxrun = run;
+    }
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  spin_unlock(&kworker->qlock);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -140,6 +325,10 @@ static int work_thread(int argc, FAR char *argv[])
   worker_t worker;
   irqstate_t flags;
   FAR void *arg;
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  clock_t start;
+  clock_t wait;
+#endif
 
   /* Get the handle from argv */
 
@@ -148,24 +337,22 @@ static int work_thread(int argc, FAR char *argv[])
   kworker = (FAR struct kworker_s *)
             ((uintptr_t)strtoul(argv[2], NULL, 16));
 
-  flags = spin_lock_irqsave(&wqueue->lock);
-  sched_lock();
-
   /* Loop forever */
 
   while (!wqueue->exit)
     {
-      /* And check each entry in the work queue.  Since we have disabled
-       * interrupts we know:  (1) we will not be suspended unless we do
-       * so ourselves, and (2) there will be no changes to the work queue
+      /* Remove the ready-to-execute work from the list.  The work is
+       * returned locked, so that there will be no changes to it until it
+       * is unlocked again.
        */
 
-      /* Remove the ready-to-execute work from the list */
-
-      while ((work = (FAR struct work_s *)dq_remfirst(&wqueue->q)) != NULL)
+      while ((work = work_pick(wqueue, kworker, &flags)) != NULL)
         {
+          sched_lock();
           if (work->worker == NULL)
             {
+              work_unlock(wqueue, work, flags);
+              sched_unlock();
               continue;
             }
 
@@ -187,17 +374,31 @@ static int work_thread(int argc, FAR char *argv[])
 
           kworker->work = work;
 
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          start = perf_gettime();
+          wait  = start - work->stime;
+#endif
+
           /* Do the work.  Re-enable interrupts while the work is being
            * performed... we don't have any idea how long this will take!
            */
 
-          spin_unlock_irqrestore(&wqueue->lock, flags);
+          work_unlock(wqueue, work, flags);
           sched_unlock();
 
           CALL_WORKER(worker, arg);
-          flags = spin_lock_irqsave(&wqueue->lock);
+
+          /* The work may have been freed by the worker.  Only its address
+           * is used from here on.
+           */
+
+          flags = work_lock(wqueue, work);
           sched_lock();
 
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          work_account(wqueue, kworker, wait, perf_gettime() - start);
+#endif
+
           /* Mark the thread un-busy */
 
           kworker->work = NULL;
@@ -209,25 +410,19 @@ static int work_thread(int argc, FAR char *argv[])
               kworker->wait_count--;
               nxsem_post(&kworker->wait);
             }
+
+          work_unlock(wqueue, work, flags);
+          sched_unlock();
         }
 
-      /* Then process queued work.  work_process will not return until: (1)
-       * there is no further work in the work queue, and (2) semaphore is
-       * posted.
+      /* Then wait for queued work.  work_idle will not return until the
+       * semaphore is posted.
        */
 
-      wqueue->wait_count++;
-      spin_unlock_irqrestore(&wqueue->lock, flags);
-      sched_unlock();
-
-      nxsem_wait_uninterruptible(&wqueue->sem);
-      flags = spin_lock_irqsave(&wqueue->lock);
       sched_lock();
+      work_idle(wqueue, kworker, flags);
     }
 
-  spin_unlock_irqrestore(&wqueue->lock, flags);
-  sched_unlock();
-
   nxsem_post(&wqueue->exsem);
   return OK;
 }
@@ -258,6 +453,9 @@ static int work_thread_create(FAR const char *name, int priority,
   FAR char *argv[3];
   char arg0[32];
   char arg1[32];
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  cpu_set_t cpuset;
+#endif
   int wndx;
   int pid;
 
@@ -270,6 +468,9 @@ static int work_thread_create(FAR const char *name, int priority,
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
       nxsem_init(&wqueue->worker[wndx].wait, 0, 0);
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+      nxsem_init(&wqueue->worker[wndx].sem, 0, 0);
+#endif
 
       snprintf(arg0, sizeof(arg0), "%p", wqueue);
       snprintf(arg1, sizeof(arg1), "%p", &wqueue->worker[wndx]);
@@ -289,6 +490,18 @@ static int work_thread_create(FAR const char *name, int priority,
         }
 
       wqueue->worker[wndx].pid = pid;
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+      wqueue->worker[wndx].tcb = nxsched_get_tcb(pid);
+
+      /* Bind each worker to one CPU, so that the work queued on a CPU is
+       * performed there unless another worker steals it.
+       */
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(wndx % CONFIG_SMP_NCPUS, &cpuset);
+      nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+#endif
     }
 
   sched_unlock();
@@ -396,7 +609,11 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+      nxsem_post(&wqueue->worker[wndx].sem);
+#else
       nxsem_post(&wqueue->sem);
+#endif
     }
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
@@ -404,6 +621,13 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
       nxsem_wait_uninterruptible(&wqueue->exsem);
     }
 
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      nxsem_destroy(&wqueue->worker[wndx].sem);
+    }
+#endif
+
   nxsem_destroy(&wqueue->sem);
   nxsem_destroy(&wqueue->exsem);
   kmm_free(wqueue);
@@ -451,6 +675,69 @@ int work_queue_priority(int qid)
   return work_queue_priority_wq(work_qid2wq(qid));
 }
 
+/****************************************************************************
+ * Name: work_queue_getstats/work_queue_getstats_wq
+ *
+ * Description:
+ *   Return the statistics of a kernel-mode work queue.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (must be HPWORK or LPWORK)
+ *   wqueue - The work queue handle
+ *   stats  - Location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+int work_queue_getstats_wq(FAR struct kwork_wqueue_s *wqueue,
+                           FAR struct work_stats_s *stats)
+{
+  irqstate_t flags;
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  FAR struct work_stats_s *wstats;
+  int wndx;
+#endif
+
+  if (wqueue == NULL || stats == NULL)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  /* Each worker keeps its own statistics */
+
+  memset(stats, 0, sizeof(*stats));
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+    {
+      wstats = &wqueue->worker[wndx].stats;
+      flags  = spin_lock_irqsave(&wqueue->worker[wndx].qlock);
+      stats->nqueued   += wstats->nqueued;
+      stats->ndone     += wstats->ndone;
+      stats->nstolen   += wstats->nstolen;
+      stats->totalwait += wstats->totalwait;
+      stats->totalrun  += wstats->totalrun;
+      stats->maxwait    = MAX(stats->maxwait, wstats->maxwait);
+      stats->maxrun     = MAX(stats->maxrun, wstats->maxrun);
+      spin_unlock_irqrestore(&wqueue->worker[wndx].qlock, flags);
+    }
+#else
+  flags = spin_lock_irqsave(&wqueue->lock);
+  *stats = wqueue->stats;
+  spin_unlock_irqrestore(&wqueue->lock, flags);
+#endif
+
+  return OK;
+}
+
+int work_queue_getstats(int qid, FAR struct work_stats_s *stats)
+{
+  return work_queue_getstats_wq(work_qid2wq(qid), stats);
+}
+#endif
+
 /****************************************************************************
  * Name: work_start_highpri
  *
@@ -33,6 +33,7 @@
 #include <stdbool.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/spinlock.h>
@@ -60,6 +61,17 @@ struct kworker_s
   FAR struct work_s *work;     /* The work structure */
   sem_t             wait;      /* Sync waiting for worker done */
   int16_t           wait_count;
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  FAR struct tcb_s  *tcb;      /* The TCB of the worker thread */
+  spinlock_t        wlock;     /* Protects the works hashed to this worker */
+  spinlock_t        qlock;     /* Protects q, idle and stats */
+  bool              idle;      /* Waiting on sem for work */
+  sem_t             sem;       /* Wakes up the idle worker */
+  struct dq_queue_s q;         /* The work pending on this worker */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct work_stats_s stats;   /* The statistics of this worker */
+#endif
+#endif
 };
 
 /* This structure defines the state of one kernel-mode work queue */
@@ -73,6 +85,10 @@ struct kwork_wqueue_s
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
   int16_t           wait_count;
+#if defined(CONFIG_SCHED_WORKQUEUE_STATS) && \
+    !defined(CONFIG_SCHED_WORKQUEUE_STEAL)
+  struct work_stats_s stats;   /* The statistics of the wqueue */
+#endif
   struct kworker_s  worker[0]; /* Describes a worker thread */
 };
 
@@ -90,6 +106,10 @@ struct hp_wqueue_s
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
   int16_t           wait_count;
+#if defined(CONFIG_SCHED_WORKQUEUE_STATS) && \
+    !defined(CONFIG_SCHED_WORKQUEUE_STEAL)
+  struct work_stats_s stats;   /* The statistics of the wqueue */
+#endif
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -111,6 +131,10 @@ struct lp_wqueue_s
   uint8_t           nthreads;  /* Number of worker threads */
   bool              exit;      /* A flag to request the thread to exit */
   int16_t           wait_count;
+#if defined(CONFIG_SCHED_WORKQUEUE_STATS) && \
+    !defined(CONFIG_SCHED_WORKQUEUE_STEAL)
+  struct work_stats_s stats;   /* The statistics of the wqueue */
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
@@ -159,6 +183,64 @@ static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
     }
 }
 
+/****************************************************************************
+ * Name: work_lock/work_unlock
+ *
+ * Description:
+ *   Lock the state of a work: its callback, its place on a pending list
+ *   and the threads waiting for it to complete.  With per-worker queues,
+ *   each work is protected by the wlock of the worker that its address
+ *   hashes to, so that unrelated works do not contend for one lock.  The
+ *   lock of a pending list is always taken after the lock of the work.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+#  define work_wlock(wqueue, work) \
+     (&(wqueue)->worker[((uintptr_t)(work) / sizeof(struct work_s)) % \
+                        (wqueue)->nthreads].wlock)
+#else
+#  define work_wlock(wqueue, work) (&(wqueue)->lock)
+#endif
+
+#define work_lock(wqueue, work) \
+  spin_lock_irqsave(work_wlock(wqueue, work))
+#define work_unlock(wqueue, work, flags) \
+  spin_unlock_irqrestore(work_wlock(wqueue, work), flags)
+
+/****************************************************************************
+ * Name: work_dequeue
+ *
+ * Description:
+ *   Remove pending work from the queue.  The caller holds the lock of the
+ *   work.
+ *
+ ****************************************************************************/
+
+static inline_function void work_dequeue(FAR struct kwork_wqueue_s *wqueue,
+                                         FAR struct work_s *work)
+{
+#ifdef CONFIG_SCHED_WORKQUEUE_STEAL
+  FAR struct kworker_s *kworker;
+
+  /* The work remembers the list that it is pending on */
+
+  if (work->pending != NULL)
+    {
+      kworker = container_of(work->pending, struct kworker_s, q);
+      spin_lock(&kworker->qlock);
+      dq_rem((FAR dq_entry_t *)work, work->pending);
+      work->pending = NULL;
+      spin_unlock(&kworker->qlock);
+    }
+#else
+  if (dq_inqueue((FAR dq_entry_t *)work, &wqueue->q))
+    {
+      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: work_start_highpri
  *
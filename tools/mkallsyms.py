@@ -39,6 +39,51 @@ except ModuleNotFoundError:
     os._exit(errno.EINVAL)
 
 
+def symbol_hash(name, seed):
+    # 32-bit FNV-1a with the seed folded into the offset basis, this must
+    # match allsyms_hash() in libs/libc/symtab/symtab_allsyms.c
+
+    h = (2166136261 ^ seed) & 0xFFFFFFFF
+    for c in name.encode():
+        h = ((h ^ c) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def perfect_hash(names):
+    # Hash and displace: the names are spread over buckets by the unseeded
+    # hash, then each bucket, largest first, gets the smallest seed that
+    # puts all of its names into free slots.  A lookup hashes the name
+    # twice and compares a single entry.
+
+    nslots = max(len(names) + len(names) // 4, 1)
+    nbuckets = max((len(names) + 3) // 4, 1)
+
+    buckets = [[] for _ in range(nbuckets)]
+    for idx, name in names:
+        buckets[symbol_hash(name, 0) % nbuckets].append((idx, name))
+
+    disps = [0] * nbuckets
+    slots = [None] * nslots
+    for b in sorted(range(nbuckets), key=lambda b: -len(buckets[b])):
+        if not buckets[b]:
+            break
+
+        for seed in range(1, 65536):
+            placed = [symbol_hash(name, seed) % nslots for _, name in buckets[b]]
+            if len(set(placed)) == len(placed) and all(
+                slots[i] is None for i in placed
+            ):
+                break
+        else:
+            raise ValueError("No perfect hash for %d symbols" % len(names))
+
+        disps[b] = seed
+        for (idx, _), i in zip(buckets[b], placed):
+            slots[i] = idx
+
+    return disps, [idx or 0 for idx in slots]
+
+
 class SymbolTables(object):
     def __init__(self, elffile, output):
         try:
@@ -64,7 +109,8 @@ class SymbolTables(object):
             noconst = ""
 
         self.emitline("#include <nuttx/compiler.h>")
-        self.emitline("#include <nuttx/symtab.h>\n")
+        self.emitline("#include <nuttx/symtab.h>")
+        self.emitline("#include <stdint.h>\n")
         self.emitline("extern int g_nallsyms;\n")
         self.emitline(
             "extern struct symtab_s g_allsyms[%d + 2];\n" % len(self.symbol_list)
@@ -81,6 +127,40 @@ class SymbolTables(object):
             )
         self.emitline('  { "Unknown", (FAR %s void *)0xffffffff }\n};' % (noconst))
 
+    def print_symbol_index(self, isnoconst=False):
+        noconst = "const"
+        if not isnoconst:
+            noconst = ""
+
+        # Index the names into g_allsyms[], skipping the leading boundary.
+        # Of several symbols with the same name, the first one is found,
+        # like a linear search would.
+
+        names = {}
+        for idx, symbol in enumerate(self.symbol_list, 1):
+            names.setdefault(symbol[1], idx)
+
+        disps, slots = perfect_hash([(idx, name) for name, idx in names.items()])
+
+        self.emitline("\nextern int g_nallsyms_hashdisp;")
+        self.emitline("extern int g_nallsyms_hashslot;")
+        self.emitline("extern uint16_t g_allsyms_hashdisp[%d];" % len(disps))
+        self.emitline("extern uint32_t g_allsyms_hashslot[%d];\n" % len(slots))
+        self.emitline("%s int g_nallsyms_hashdisp = %d;" % (noconst, len(disps)))
+        self.emitline("%s int g_nallsyms_hashslot = %d;" % (noconst, len(slots)))
+        self.emitline(
+            "%s uint16_t g_allsyms_hashdisp[%d] =\n{" % (noconst, len(disps))
+        )
+        for i in range(0, len(disps), 8):
+            self.emitline("  %s," % ", ".join(str(d) for d in disps[i : i + 8]))
+        self.emitline("};\n")
+        self.emitline(
+            "%s uint32_t g_allsyms_hashslot[%d] =\n{" % (noconst, len(slots))
+        )
+        for i in range(0, len(slots), 8):
+            self.emitline("  %s," % ", ".join(str(s) for s in slots[i : i + 8]))
+        self.emitline("};")
+
     def get_symtable(self):
         symbol_tables = [
             (idx, s)
@@ -147,6 +227,14 @@ if __name__ == "__main__":
         action="version",
         version="mkallsyms.py: based on pyelftools %s" % __version__,
     )
+    parser.add_argument(
+        "--index",
+        nargs="?",
+        const=False,
+        default=False,
+        help='Emit a name hash index, the symbols stay ordered by value '
+        '(specify "y" to enable, default: False).',
+    )
     parser.add_argument(
         "--orderbyname",
         nargs="?",
@@ -157,5 +245,7 @@ if __name__ == "__main__":
     args = parser.parse_args()
 
     readelf = SymbolTables(args.elffile, args.outfile)
-    readelf.parse_symbol(args.orderbyname)
+    readelf.parse_symbol(args.orderbyname and not args.index)
     readelf.print_symbol_tables(args.noconst)
+    if args.index:
+        readelf.print_symbol_index(args.noconst)